@@ -43,6 +43,7 @@
 #include "common.h"
 #include "matds.h"
 #include <climits>
+#include <omp.h>
 #include <queue>
 #include <stack>
 #include <vector>
@@ -52,4 +53,93 @@ using std::stack;
 
 void compute_ser_bc_cpu(matrix_pcsr_t *g, double *bc_scores, bool directed);
 
+/**
+ * @brief Computes the Betweenness Centrality on the CPU distributing the
+ * sources of the Brandes algorithm among OpenMP threads.
+ *
+ * Each thread owns its own sigma, d and delta arrays and a flat array that is
+ * used both as the BFS queue and, walked backwards, as the stack for the
+ * dependency accumulation. Scratch arrays are allocated once and only the
+ * entries touched by a source are reset before the next one.
+ *
+ * The sources are visited in rounds of one source per thread, after which
+ * the threads add the dependencies of the round to the scores, each one
+ * summing a range of vertices.
+ *
+ * @note The dependencies of each source are added to the scores in the same
+ * order of the serial algorithm, so the result is bit-for-bit identical to
+ * the one of compute_ser_bc_cpu regardless of the number of threads.
+ *
+ * @cite brandes_faster_2001
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_par_bc_cpu(matrix_pcsr_t *g,
+                       double *bc_scores,
+                       bool directed,
+                       int nthreads);
+
+/**
+ * @brief Computes the Betweenness Centrality on the CPU with the layout of
+ * the work-efficient GPU technique: the BFS of each source is level
+ * synchronous and appends the vertices of each level to a flat stack, whose
+ * ends array stores where each level begins.
+ *
+ * The backward propagation walks the levels in reverse as contiguous ranges
+ * of the stack, and each vertex pulls the dependency from its successors,
+ * so neither predecessor lists nor a check on both endpoints of an edge are
+ * needed. Once the dependency of a vertex is final, it is replaced by
+ * (1 + delta) / sigma, the term added to each of its predecessors.
+ *
+ * Each thread allocates its scratch arrays and its scores once, so the
+ * visit of a source does not allocate memory.
+ *
+ * @note Unlike compute_par_bc_cpu, each thread accumulates the scores of its
+ * sources, which are summed at the end, so the result equals the one of
+ * compute_ser_bc_cpu only up to rounding.
+ *
+ * @cite brandes_faster_2001
+ * @cite mclaughlin_scalable_2014
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and number of traversed edges, may be 0
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_ls_bc_cpu(matrix_pcsr_t *g,
+                      double *bc_scores,
+                      bool directed,
+                      int nthreads,
+                      stats_t *stats);
+
+/**
+ * @brief Backward propagation of the level synchronous Brandes algorithm
+ * for a single source, whose vertices at depth l are the ones of stack
+ * between ends[l] and ends[l + 1]. Adds the dependency of each vertex on
+ * the source to bc_scores.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in] stack vertices reached from the source, level by level
+ * @param[in] ends start of each level in stack, depth + 1 entries
+ * @param[in] depth number of levels, the source included
+ * @param[in] d depth of each vertex reached from the source
+ * @param[in] sigma number of shortest paths of each reached vertex
+ * @param[out] delta scratch array of nvertices elements
+ * @param[in, out] bc_scores array that accumulates the dependencies
+ */
+void accumulate_ls_dependencies(matrix_pcsr_t *g,
+                                const int *stack,
+                                const int *ends,
+                                int depth,
+                                const int *d,
+                                const unsigned long long *sigma,
+                                double *delta,
+                                double *bc_scores);
+
 #endif//SOCNETALGSONGPU_BC_H
@@ -0,0 +1,191 @@
+/****************************************************************************
+ * @file bc_approx.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Functions to approximate the betweenness centrality of the vertices
+ * of an unweighted graph by sampling sources or shortest paths.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef SOCNETALGSONGPU_BC_APPROX_H
+#define SOCNETALGSONGPU_BC_APPROX_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "graphs.h"
+#include "matds.h"
+#include <climits>
+#include <cmath>
+#include <omp.h>
+
+/*
+ * Shortest paths sampled before the first check of the top-k technique,
+ * doubled at each of the following checks.
+ */
+#define TOPK_FIRST_SAMPLES 1024
+
+/*
+ * Pivots whose dependencies are summed by the same thread before being
+ * added to the scores, in the order of the chunks.
+ */
+#define APPROX_PIVOT_CHUNK 8
+
+/**
+ * List the distributions from which pivots are sampled.
+ */
+enum PivotStrategy {
+    uniform_pivots = 0,
+    degree_pivots  = 1
+};
+
+typedef struct approx_params_t {
+    int nsamples;         // number of pivots, 0 to sample shortest paths
+    PivotStrategy pivots; // distribution of the pivots
+    double epsilon;       // maximum error on normalized scores
+    double delta;         // probability that the error exceeds epsilon
+    unsigned long long seed;
+} approx_params_t;
+
+/**
+ * @brief Approximates the Betweenness Centrality by running the Brandes
+ * algorithm from p->nsamples pivots, as proposed by Brandes and Pich.
+ *
+ * Pivots are drawn with replacement, uniformly or with probability
+ * proportional to their degree, and the dependencies of each pivot are
+ * weighted by the inverse of its probability so that the estimate is
+ * unbiased. Chunks of APPROX_PIVOT_CHUNK pivots are distributed among
+ * OpenMP threads, and the sum of each chunk is added to the scores in the
+ * order of the chunks, so the estimate does not depend on the number of
+ * threads nor on the scheduling.
+ *
+ * The error bound follows from the Hoeffding inequality and the union bound
+ * over all vertices: with probability at least 1 - p->delta every score is
+ * within err_bound from the exact one.
+ *
+ * @cite brandes_centrality_2007
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] p sampling parameters
+ * @param[out] err_bound absolute error bound on the scores
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and edges traversed, can be null
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_approx_bc_pivots(matrix_pcsr_t *g,
+                             double *bc_scores,
+                             bool directed,
+                             approx_params_t *p,
+                             double *err_bound,
+                             int nthreads,
+                             stats_t *stats);
+
+/**
+ * @brief Approximates the Betweenness Centrality by sampling shortest paths
+ * between random pairs of vertices, as proposed by Riondato and Kornaropoulos.
+ *
+ * The number of samples is the one for which, with probability at least
+ * 1 - p->delta, every normalized score is within p->epsilon from the exact
+ * one. It depends on an upper bound of the vertex diameter obtained with a
+ * single BFS, so the sampling stops as soon as the guarantee holds.
+ *
+ * @cite riondato_fast_2016
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] p sampling parameters
+ * @param[out] err_bound absolute error bound on the scores
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and edges traversed, can be null
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_approx_bc_paths(matrix_pcsr_t *g,
+                            double *bc_scores,
+                            bool directed,
+                            approx_params_t *p,
+                            double *err_bound,
+                            int nthreads,
+                            stats_t *stats);
+
+/**
+ * @brief Approximates the Betweenness Centrality sampling pivots if
+ * p->nsamples is positive and shortest paths otherwise.
+ *
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_approx_bc_cpu(matrix_pcsr_t *g,
+                          double *bc_scores,
+                          bool directed,
+                          approx_params_t *p,
+                          double *err_bound,
+                          int nthreads,
+                          stats_t *stats);
+
+/**
+ * @brief Finds the k vertices with the highest Betweenness Centrality by
+ * sampling shortest paths in batches of doubling size, stopping as soon as
+ * the top-k set is certified, as in KADABRA @cite borassi_kadabra_2019.
+ *
+ * After each batch every vertex gets a confidence interval from the
+ * empirical Bernstein bound @cite maurer_empirical_2009, so that the
+ * intervals of the vertices with the highest estimates are tight while the
+ * ones of the rest of the graph are dominated by their small variance. The
+ * sampling stops when the lower bounds of the top-k estimates are above the
+ * upper bounds of all the other vertices, when every interval is within
+ * p->epsilon or after the samples of compute_approx_bc_paths. In any case
+ * the result is correct with probability at least 1 - p->delta.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the estimated bc score of each
+ * vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] k number of vertices to find
+ * @param[in] p sampling parameters
+ * @param[out] topk ids of the min(k, n) vertices with the highest scores,
+ * from the highest
+ * @param[out] err_bound absolute error bound on the scores
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and edges traversed, can be null
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_topk_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        bool directed,
+                        int k,
+                        approx_params_t *p,
+                        int *topk,
+                        double *err_bound,
+                        int nthreads,
+                        stats_t *stats);
+
+#endif//SOCNETALGSONGPU_BC_APPROX_H
@@ -0,0 +1,127 @@
+/****************************************************************************
+ * @file bc_batch.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Batched Brandes algorithm that computes the Betweenness Centrality
+ * from many sources per traversal on the CPU.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef BC_BATCH_H
+#define BC_BATCH_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+
+/*
+ * Number of sources visited together by the batched Brandes algorithm. The
+ * entries of a vertex for all the sources fill one AVX-512 register of
+ * doubles, or two AVX2 ones.
+ */
+#define BATCH_LANES 8
+
+/**
+ * @brief Scratch memory of the batched Brandes algorithm. The arrays d,
+ * sigma and delta store the entries of a vertex for the BATCH_LANES sources
+ * of the batch next to each other, at index vertex * BATCH_LANES + lane.
+ *
+ * The number of shortest paths is stored as a double, so that its lanes are
+ * updated with the same vectors of the dependencies. A vertex at different
+ * distances from the sources belongs to one level for each distance, so the
+ * stack can hold each vertex BATCH_LANES times.
+ */
+typedef struct batch_workspace_t {
+    int nvertices;
+    int *d;
+    double *sigma;
+    double *delta;
+    int *stack;  // vertices of each level, one level after the other
+    int *ends;   // index in the stack of the first vertex of each level
+    int *level;  // last level each vertex was appended to, -1 if none
+} batch_workspace_t;
+
+int init_batch_workspace(batch_workspace_t *ws, int nvertices);
+
+void free_batch_workspace(batch_workspace_t *ws);
+
+/**
+ * @brief Runs the Brandes algorithm from the given sources at once and adds
+ * their dependencies to the scores, as proposed by Sariyüce et al. for
+ * GPUs and vector units.
+ *
+ * The visit is level synchronous over all the sources: a vertex is expanded
+ * at a level if it is at that distance from any source, and the read of its
+ * adjacency list serves all of them. The updates of the entries of a
+ * neighbor for the sources of the batch are vectorized. The backward
+ * propagation walks the levels in reverse and each vertex pulls the
+ * dependencies of its successors, as in compute_ls_bc_cpu.
+ *
+ * @cite sariyuce_regularizing_2015
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in] sources distinct sources of the batch
+ * @param[in] nsources number of sources, at most BATCH_LANES
+ * @param[in, out] ws workspace initialized with init_batch_workspace
+ * @param[in, out] bc_scores scores the dependencies are added to
+ * @return number of edges traversed
+ */
+unsigned long long batch_bc_visit(matrix_pcsr_t *g,
+                                  const int *sources,
+                                  int nsources,
+                                  batch_workspace_t *ws,
+                                  double *bc_scores);
+
+/**
+ * @brief Computes the Betweenness Centrality on the CPU with the batched
+ * Brandes algorithm, distributing the batches of BATCH_LANES sources among
+ * OpenMP threads.
+ *
+ * @note Each thread accumulates the scores of its batches, which are summed
+ * at the end, so the result equals the one of compute_ser_bc_cpu only up to
+ * rounding.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and number of traversed edges, may be 0
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_batch_bc_cpu(matrix_pcsr_t *g,
+                         double *bc_scores,
+                         bool directed,
+                         int nthreads,
+                         stats_t *stats);
+
+#endif//BC_BATCH_H
@@ -0,0 +1,113 @@
+/****************************************************************************
+ * @file bc_bcc.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Exact betweenness centrality on the CPU by decomposition of the graph
+ * into biconnected components.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#pragma once
+#ifndef BC_BCC_H
+#define BC_BCC_H
+
+#include "bc_fold.h"
+#include "bc_statistics.h"
+#include "common.h"
+#include "graphs.h"
+#include "matds.h"
+#include <omp.h>
+
+/*
+ * Blocks with at least this many vertices are processed one at a time with
+ * all the threads, the smaller ones are distributed among the threads.
+ */
+#define BCC_LARGE_BLOCK 1024
+
+/**
+ * @brief Biconnected components (blocks) of an undirected graph, as found by
+ * the Hopcroft-Tarjan algorithm. Each block is entered by the depth-first
+ * search from its top vertex, the only one whose subtree is not contained in
+ * the block.
+ */
+typedef struct blocks_t {
+    int nvertices;      // vertices of the graph
+    int nblocks;        // number of blocks
+    int *offsets;       // start of each block in vertices
+    int *vertices;      // sorted ids of the vertices of each block
+    int *top;           // top vertex of each block
+    int *below;         // vertices in the subtree of the search below a block
+    int *cc_size;       // size of the connected component of each vertex
+    bool *is_cut;       // whether each vertex is an articulation point
+} blocks_t;
+
+/**
+ * @brief Finds the biconnected components and the articulation points of an
+ * undirected graph with an iterative Hopcroft-Tarjan depth-first search
+ * @cite hopcroft_algorithm_1973.
+ *
+ * Isolated vertices do not belong to any block.
+ *
+ * @param[in] g input undirected graph
+ * @param[out] b blocks of g
+ * @return 0 if successful, 1 otherwise
+ */
+int get_blocks(matrix_pcsr_t *g, blocks_t *b);
+
+void free_blocks(blocks_t *b);
+
+/**
+ * @brief Computes the exact Betweenness Centrality of an undirected graph
+ * block by block @cite puzis_heuristics_2012 @cite sariyuce_shattering_2013.
+ *
+ * Every shortest path crossing a block enters and leaves it through two of
+ * its vertices, so each vertex u of a block B stands for the r_B(u) vertices
+ * that reach B through u, and the weighted Brandes algorithm on B gives the
+ * dependency of its vertices on the paths through B. If removing an
+ * articulation point v leaves components of sizes c_1, ..., c_k, all the
+ * paths between them pass through v, which gains
+ * ((n - 1)^2 - sum c_i^2) / 2 in closed form.
+ *
+ * Each block is materialized with extract_subgraph_map, blocks with two
+ * vertices have no inner vertex and are skipped.
+ *
+ * @param[in] g input undirected graph
+ * @param[out] bc_scores bc score of each vertex
+ * @param[in] nthreads number of threads, all available if not positive
+ * @param[out] stats runtime of the computation
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_bcc_bc_cpu(matrix_pcsr_t *g,
+                       double *bc_scores,
+                       int nthreads,
+                       stats_t *stats);
+
+#endif//BC_BCC_H
@@ -0,0 +1,132 @@
+/****************************************************************************
+ * @file bc_fold.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Exact betweenness centrality on the CPU with folding of degree-one
+ * vertices.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef BC_FOLD_H
+#define BC_FOLD_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "graphs.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+
+/**
+ * @brief Result of the iterative removal of degree-one vertices from an
+ * undirected connected graph. Each removed vertex is folded into its last
+ * neighbor, which then represents the whole subtree hanging from it.
+ */
+typedef struct fold_t {
+    int nvertices;   // vertices of the original graph
+    int ncore;       // vertices left after folding
+    int *core;       // sorted ids of the vertices left
+    int *weight;     // vertices represented by each vertex, itself included
+    double *sum_sq;  // sum of the squared weights of the folded neighbors
+} fold_t;
+
+/**
+ * @brief Iteratively remove the vertices with degree one.
+ *
+ * At least one vertex is always left, so a tree is folded into a single
+ * vertex.
+ *
+ * @param[in] g input undirected connected graph
+ * @param[out] f folding of g
+ * @return 0 if successful, 1 otherwise
+ */
+int fold_degree_one(matrix_pcsr_t *g, fold_t *f);
+
+void free_fold(fold_t *f);
+
+/**
+ * @brief Computes the Betweenness Centrality of a graph whose vertices stand
+ * for weight[v] vertices each, so that the dependency of a pair (s, t) is
+ * weight[s] * weight[t] times the fraction of its shortest paths through v.
+ *
+ * Sources are distributed among OpenMP threads, each one accumulating in its
+ * own array of scores.
+ *
+ * @param[in] g input undirected graph
+ * @param[in] weight weight of each vertex
+ * @param[out] bc_scores bc score of each vertex, counting unordered pairs
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_weighted_bc_cpu(matrix_pcsr_t *g,
+                            const int *weight,
+                            double *bc_scores,
+                            int nthreads);
+
+/**
+ * @brief Computes the Betweenness Centrality of a graph where the source s
+ * stands for mult[s] sources with the same dependencies, so that only the
+ * sources with a positive multiplicity are visited.
+ *
+ * @param[in] g input undirected graph
+ * @param[in] mult multiplicity of each source
+ * @param[out] bc_scores bc score of each vertex, counting unordered pairs
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_multi_source_bc_cpu(matrix_pcsr_t *g,
+                                const int *mult,
+                                double *bc_scores,
+                                int nthreads);
+
+/**
+ * @brief Computes the exact Betweenness Centrality of an undirected connected
+ * graph by running the weighted Brandes algorithm only on the vertices left
+ * after folding the degree-one ones @cite baglioni_fast_2012.
+ *
+ * Pairs whose shortest paths leave the subtrees folded into a vertex v all
+ * pass through v, so if the folded neighbors of v represent a_1, ..., a_k
+ * vertices and the rest of the graph n - weight[v], v gains
+ * ((n - 1)^2 - sum a_i^2 - (n - weight[v])^2) / 2 in closed form, while
+ * the pairs among the rest of the graph are counted on the core.
+ *
+ * @param[in] g input undirected connected graph
+ * @param[out] bc_scores bc score of each vertex
+ * @param[in] nthreads number of threads, all available if not positive
+ * @param[out] stats runtime of the computation
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_folded_bc_cpu(matrix_pcsr_t *g,
+                          double *bc_scores,
+                          int nthreads,
+                          stats_t *stats);
+
+#endif//BC_FOLD_H
@@ -0,0 +1,84 @@
+/****************************************************************************
+ * @file bc_spmm.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Betweenness Centrality on the CPU expressed with masked sparse matrix
+ * products over semirings.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef BC_SPMM_H
+#define BC_SPMM_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "matds.h"
+#include "spmatops.h"
+#include <climits>
+#include <omp.h>
+
+/*
+ * Number of sources, and columns of the blocks, of each batch of the
+ * algebraic Brandes algorithm.
+ */
+#define SPMM_BC_LANES 8
+
+/**
+ * @brief Computes the Betweenness Centrality on the CPU with the Brandes
+ * algorithm written as sparse matrix products, as in GraphBLAS. Batches of
+ * SPMM_BC_LANES sources are distributed among OpenMP threads.
+ *
+ * For a batch, the frontier is a block with a column for each source. The
+ * BFS step is the product A' * F over (+, *), masked by the entries not
+ * visited yet, which gives the number of shortest paths to the next
+ * frontier, accumulated in the dense sigma block. The level of each entry
+ * is kept in a single array, which is the mask of every level. The backward
+ * sweep is the product A * T over (+, *), masked by the entries of the
+ * level, where T holds (1 + delta) / sigma of the entries of the next level.
+ *
+ * @cite kepner_graph_2011
+ * @cite buluc_parallel_2012
+ * @cite brandes_faster_2001
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and number of traversed edges, may be 0
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_spmm_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        bool directed,
+                        int nthreads,
+                        stats_t *stats);
+
+#endif//BC_SPMM_H
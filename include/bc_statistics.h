@@ -118,4 +118,34 @@ int dump_scores(int nvertices,
                 const double *cl_scores,
                 char *fname);
 
+/**
+ * @brief Dump to a file the scores of the given vertices only, in the given
+ * order, with the same format of dump_scores.
+ *
+ * @param nselected number of vertices to be dumped
+ * @param selected ids of the vertices to be dumped, all of them if 0
+ * @return 0 if successful, -1 if the stream was not closed correctly,
+ * 1 if another error occurred
+ */
+int dump_selected_scores(int nselected,
+                         const int *selected,
+                         const int *degree_scores,
+                         const double *bc_scores,
+                         const double *cl_scores,
+                         char *fname);
+
+/**
+ * @brief Dump the scores of a directed graph to a file, with the in-degree
+ * and the out-degree of each vertex in place of the degree.
+ *
+ * @return 0 if successful, -1 if the stream was not closed correctly,
+ * 1 if another error occurred
+ */
+int dump_directed_scores(int nvertices,
+                         const int *in_degree,
+                         const int *out_degree,
+                         const double *bc_scores,
+                         const double *cl_scores,
+                         char *fname);
+
 #endif//BC_STATISTICS_H
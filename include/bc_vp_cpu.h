@@ -0,0 +1,118 @@
+/****************************************************************************
+ * @file bc_vp_cpu.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Vertex-parallel Betweenness Centrality on the CPU with vectorized
+ * frontier compaction and initialization.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef BC_VP_CPU_H
+#define BC_VP_CPU_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+
+/**
+ * @brief Instruction sets of the kernels of the vertex-parallel technique on
+ * the CPU, from the slowest to the fastest.
+ */
+enum SimdLevel {
+    simd_scalar = 0,
+    simd_avx2   = 1,
+    simd_avx512 = 2
+};
+
+/**
+ * @brief Get the widest instruction set supported by the CPU that runs the
+ * program, checked at runtime.
+ */
+SimdLevel get_simd_level();
+
+/**
+ * @brief Get the name of an instruction set, 0 if the id is not valid.
+ */
+const char *get_simd_name(SimdLevel level);
+
+/**
+ * @brief Writes to frontier the vertices at distance depth from the source,
+ * in increasing order, as the threads of the vertex-parallel GPU technique
+ * find them by testing d[v] == depth for every vertex.
+ *
+ * @param[in] d distance of each vertex from the source
+ * @param[in] nvertices number of vertices
+ * @param[in] depth distance of the vertices of the frontier
+ * @param[out] frontier array of at least nvertices elements
+ * @param[in] level widest instruction set used, lowered to the one
+ * supported by the CPU
+ * @return the number of vertices of the frontier
+ */
+int compact_frontier(const int *d,
+                     int nvertices,
+                     int depth,
+                     int *frontier,
+                     SimdLevel level);
+
+/**
+ * @brief Computes the Betweenness Centrality on the CPU as the
+ * vertex-parallel GPU technique does: the vertices of each level of the BFS
+ * of a source are found by scanning the distances of all the vertices, and
+ * the arrays of the source are reset in full before its visit.
+ *
+ * The scan, which runs once per level and dominates on graphs with a large
+ * diameter, and the reset are vectorized with AVX2 or AVX-512 when the CPU
+ * supports them. The frontiers found by the scans are kept one after the
+ * other, so the backward propagation walks them in reverse, each vertex
+ * pulling the dependency from its successors.
+ *
+ * @cite brandes_faster_2001
+ * @cite jia_chapter_2012
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] level widest instruction set used, lowered to the one
+ * supported by the CPU
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats runtime and number of traversed edges, may be 0
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_vp_bc_cpu(matrix_pcsr_t *g,
+                      double *bc_scores,
+                      bool directed,
+                      SimdLevel level,
+                      int nthreads,
+                      stats_t *stats);
+
+#endif//BC_VP_CPU_H
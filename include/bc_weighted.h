@@ -0,0 +1,123 @@
+/****************************************************************************
+ * @file bc_weighted.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Functions to compute the Betweenness and the Closeness Centrality of
+ * graphs with positive integer weights on the CPU.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#pragma once
+#ifndef BC_WEIGHTED_H
+#define BC_WEIGHTED_H
+
+#include "bc_statistics.h"
+#include "common.h"
+#include "graphs.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+#include <vector>
+
+/*
+ * One bucket for the keys equal to the last one extracted and one for each
+ * bit of the keys.
+ */
+#define RADIX_NBUCKETS 65
+
+typedef struct radix_item_t {
+    unsigned long long key;
+    int vertex;
+} radix_item_t;
+
+/**
+ * @brief Monotone priority queue for integer keys as proposed by Ahuja et
+ * al. An item whose key differs from the last extracted one in the i-th bit
+ * at most lives in bucket i + 1, so only the first non-empty bucket is
+ * redistributed when bucket 0 runs out and each item moves down at most 64
+ * times. Keys must not be smaller than the last one extracted.
+ *
+ * @cite ahuja_faster_1990
+ */
+typedef struct radix_heap_t {
+    unsigned long long last;// last key extracted
+    int size;
+    std::vector<radix_item_t> buckets[RADIX_NBUCKETS];
+} radix_heap_t;
+
+void radix_heap_clear(radix_heap_t *h);
+
+void radix_heap_push(radix_heap_t *h, unsigned long long key, int vertex);
+
+/**
+ * @brief Removes an item with the minimum key, the heap must not be empty.
+ */
+radix_item_t radix_heap_pop(radix_heap_t *h);
+
+/**
+ * @brief Computes the Betweenness Centrality of a weighted graph with the
+ * Brandes algorithm, in which the BFS of each source is replaced by the
+ * Dijkstra algorithm over a radix heap. Sources are distributed among
+ * OpenMP threads, each one with its own heap and scratch arrays.
+ *
+ * @note Weights must be positive, shortest paths of equal length are
+ * counted as distinct paths.
+ *
+ * @cite brandes_faster_2001
+ *
+ * @param[in] g input graph with the weight of each edge
+ * @param[out] bc_scores array that stores the bc score of each vertex
+ * @param[in] directed whether the graph is directed
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] stats computation time and edges relaxed, can be null
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_dijkstra_bc_cpu(matrix_rcsr_t *g,
+                            double *bc_scores,
+                            bool directed,
+                            int nthreads,
+                            stats_t *stats);
+
+/**
+ * @brief Computes the Closeness Centrality of a weighted graph from the
+ * lengths of the shortest paths found by the Dijkstra algorithm.
+ *
+ * @note As in compute_cl_cpu, each unreachable vertex counts INT_MAX in the
+ * farness.
+ *
+ * @param[in] g input graph with the positive weight of each edge
+ * @param[out] cl_scores array that stores the closeness of each vertex
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_dijkstra_cl_cpu(matrix_rcsr_t *g, double *cl_scores, int nthreads);
+
+#endif//BC_WEIGHTED_H
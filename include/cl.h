@@ -2,7 +2,7 @@
  * @file cl.h
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Function to compute the closeness centrality on the CPU serially.
+ * @brief Functions to compute the closeness centrality on the CPU.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -42,7 +42,69 @@
 #include "graphs.h"
 #include "matds.h"
 #include <climits>
+#include <omp.h>
 
 void compute_cl_cpu(matrix_pcsr_t *g, double *cl_cpu);
 
+/**
+ * @brief Computes the harmonic closeness of each vertex, the mean of the
+ * inverse of its distances to the other vertices, which are followed along
+ * the out-edges in a directed graph.
+ *
+ * @note Unlike compute_cl_cpu, unreachable vertices just add zero, so the
+ * scores of a graph that is not strongly connected remain meaningful.
+ *
+ * @cite boldi_axioms_2014
+ *
+ * @param[in] g input graph
+ * @param[out] cl_cpu harmonic closeness of each vertex, in [0, 1]
+ */
+void compute_harmonic_cl_cpu(matrix_pcsr_t *g, double *cl_cpu);
+
+/**
+ * @brief Computes the Wasserman-Faust closeness of each vertex, the classic
+ * closeness within the vertices it reaches scaled by their fraction of the
+ * graph: (r - 1)^2 / ((n - 1) * sum of the distances) if v reaches r
+ * vertices itself included, 0 if it reaches none.
+ *
+ * @cite wasserman_social_1994
+ *
+ * @param[in] g input graph
+ * @param[out] cl_cpu Wasserman-Faust closeness of each vertex, in [0, 1]
+ */
+void compute_wf_cl_cpu(matrix_pcsr_t *g, double *cl_cpu);
+
+/**
+ * @brief Computes the exact closeness centrality of the k vertices with the
+ * lowest farness, as proposed by Bergamini et al.
+ *
+ * Sources are visited by decreasing degree, so that the k-th best farness
+ * found so far drops quickly. After each level d of a visit from s, the
+ * vertices not yet reached are at distance at least d + 1, and at most
+ * gamma of them at distance d + 1, where gamma counts the edges leaving the
+ * level towards new vertices. The visit is cut as soon as this lower bound
+ * of the farness of s exceeds the k-th best, since s cannot enter the
+ * top-k. Sources are distributed among OpenMP threads.
+ *
+ * @cite bergamini_computing_2016
+ *
+ * @note The closeness of the top-k vertices is identical to the one of
+ * compute_cl_cpu, ties are broken by the lowest id.
+ *
+ * @param[in] g input undirected graph
+ * @param[in] k number of vertices to find
+ * @param[out] topk ids of the min(k, n) vertices with the highest closeness,
+ * from the highest
+ * @param[out] cl closeness of the vertices in topk
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @param[out] nedges_visited edges inspected by all the visits, can be null
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_topk_cl_cpu(matrix_pcsr_t *g,
+                        int k,
+                        int *topk,
+                        double *cl,
+                        int nthreads,
+                        unsigned long long *nedges_visited);
+
 #endif//CL_CPU_H
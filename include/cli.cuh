@@ -42,20 +42,45 @@
 #include <cstdio>
 #include <cstdlib>
 #include <unistd.h>
+#include <bc_approx.h>
+#include <bc_batch.h>
+#include <bc_spmm.h>
+#include <bc_bcc.h>
+#include <bc_fold.h>
 #include <bc_statistics.h>
+#include <bc_vp_cpu.h>
+#include <msbfs.h>
+#include <reorder.h>
+#include <twins.h>
 #include <device_props.cuh>
 #include <getopt.h>
 
 #define EXIT_WHELP_OR_USAGE 2
-#define NTECHNIQUES 3
+#define NTECHNIQUES 13
 
 /**
- * List all parallelization strategies used for computing BC on the GPU.
+ * List all parallelization strategies used for computing BC on the GPU, the
+ * approximation by sampling, the exact computations with degree-one
+ * folding, biconnected components and twin compression, the search of
+ * the top-k vertices, the level synchronous and the batched Brandes
+ * algorithms, the vectorized vertex-parallel technique, the algebraic
+ * formulation with sparse matrix products and the source-parallel Brandes
+ * algorithm on the CPU.
  */
 enum ParStrategy {
-    vertex_parallel = 1,
-    edge_parallel   = 2,
-    work_efficient  = 3
+    vertex_parallel     = 1,
+    edge_parallel       = 2,
+    work_efficient      = 3,
+    approximate         = 4,
+    folded              = 5,
+    biconnected         = 6,
+    twins               = 7,
+    top_k               = 8,
+    level_sync          = 9,
+    vertex_parallel_cpu = 10,
+    batched             = 11,
+    algebraic           = 12,
+    source_parallel_cpu = 13
 };
 
 typedef struct params_t {
@@ -63,8 +88,15 @@ typedef struct params_t {
     int verbose;
     int quiet;
     int self_loops_allowed;
+    int use_cache;
+    int use_scc;
     int device_id;
+    int nthreads;
+    int topk;
     ParStrategy technique;
+    ReorderStrategy reorder;
+    ClosenessKind closeness;
+    approx_params_t approx;
     char *dump_scores;
     char *dump_stats;
     char *input_file;
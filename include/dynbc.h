@@ -0,0 +1,109 @@
+/****************************************************************************
+ * @file dynbc.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Incremental update of the exact betweenness centrality of an
+ * undirected graph after batches of edge insertions and deletions.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#pragma once
+#ifndef DYNBC_H
+#define DYNBC_H
+
+#include "bc.h"
+#include "bc_fold.h"
+#include "common.h"
+#include "graphs.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+
+/**
+ * @brief Insertion or deletion of the undirected edge (u, v).
+ */
+typedef struct edge_update_t {
+    int u;
+    int v;
+    bool insert;
+} edge_update_t;
+
+/**
+ * @brief Undirected graph whose Betweenness Centrality is kept up to date
+ * while edges are inserted and deleted.
+ */
+typedef struct dynbc_t {
+    matrix_pcsr_t g;      // current graph, with sorted rows
+    double *bc_scores;    // bc score of each vertex of the current graph
+    int nthreads;         // threads used by the updates
+} dynbc_t;
+
+/**
+ * @brief Copies the graph and computes its Betweenness Centrality from
+ * scratch.
+ *
+ * @param[out] dyn graph with up to date scores
+ * @param[in] g input undirected graph, which is not modified
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int init_dynbc(dynbc_t *dyn, matrix_pcsr_t *g, int nthreads);
+
+void free_dynbc(dynbc_t *dyn);
+
+/**
+ * @brief Applies a batch of edge insertions and deletions and updates the
+ * scores by visiting again only the affected sources.
+ *
+ * In an undirected graph d(s, u) is the distance found by a BFS from u, so
+ * two visits from the endpoints of each updated edge (u, v) tell the sources
+ * with d(s, u) != d(s, v), the only ones whose shortest paths can cross it
+ * @cite lee_qube_2012 @cite jamour_parallel_2018. The dependencies of the
+ * affected sources are computed on the graph before and after the batch and
+ * their difference is added to the scores, so nothing is stored per source.
+ * If at least half of the sources are affected, the scores are computed
+ * again from scratch.
+ *
+ * Deletions are applied before insertions. Inserting an edge already present,
+ * deleting a missing edge and self-loops leave the graph as it is.
+ *
+ * @param[in, out] dyn graph with up to date scores
+ * @param[in] updates edges to insert or delete
+ * @param[in] nupdates number of updates
+ * @param[out] naffected number of sources visited again, if not 0
+ * @return 0 if successful, 1 otherwise
+ */
+int update_dynbc(dynbc_t *dyn,
+                 const edge_update_t *updates,
+                 int nupdates,
+                 int *naffected);
+
+#endif//DYNBC_H
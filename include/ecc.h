@@ -2,8 +2,8 @@
  * @file ecc.h
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Functions to compute the diameter of an undirected graph, the
- * eccentricity of its vertices and to get the graph density.
+ * @brief Functions to compute the diameter and the radius of an undirected
+ * graph, the eccentricity of its vertices and to get the graph density.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -40,20 +40,41 @@
 
 #include "graphs.h"
 #include "matds.h"
+#include "msbfs.h"
 #include <climits>
 
 /**
  * @brief Compute the diameter of the given undirected graph.
  *
- * @note The diameter is computed without using sampling techniques. It is
- * obtained by performing breadth-first searches starting from each
- * vertex and by iterating over the eccentricities' array to find the maximum.
+ * @note The diameter is exact and usually needs a few tens of visits. A
+ * 4-sweep gives a lower bound and a vertex u close to the center, then the
+ * iFUB algorithm visits the vertices from the farthest from u and stops when
+ * the lower bound exceeds the upper bound 2 * (i - 1) of the eccentricity of
+ * the vertices at distance i - 1 from u.
+ *
+ * @cite crescenzi_computing_2013
  *
  * @param g input graph in CSR format stored as sparse pattern matrix
- * @return the diameter if successful, -1 otherwise
+ * @return the diameter if successful, INT_MAX if the graph is disconnected,
+ * -1 otherwise
  */
 int get_diameter(matrix_pcsr_t *g);
 
+/**
+ * @brief Compute the radius of the given undirected graph.
+ *
+ * @note The radius is exact, visits are performed only from the vertices
+ * whose lower bound of the eccentricity is smaller than the lowest
+ * eccentricity found so far.
+ *
+ * @cite takes_computing_2013
+ *
+ * @param g input graph in CSR format stored as sparse pattern matrix
+ * @return the radius if successful, INT_MAX if the graph is disconnected,
+ * -1 otherwise
+ */
+int get_radius(matrix_pcsr_t *g);
+
 /**
  * @brief Get the eccentricity of each vertex in the given graph.
  *
@@ -2,7 +2,7 @@
  * @file graphs.h
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Algorithms for undirected unweighted graphs manipulation.
+ * @brief Algorithms for unweighted graphs manipulation.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -46,6 +46,20 @@
 #include <algorithm>
 #include <ecc.h>
 
+/*
+ * Parameters of the heuristic used by the direction-optimizing BFS to switch
+ * from top-down to bottom-up (alpha) and back (beta).
+ */
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+/*
+ * Number of neighbors of each vertex linked by Afforest before sampling the
+ * largest component, and number of vertices sampled.
+ */
+#define AFFOREST_ROUNDS 2
+#define AFFOREST_SAMPLES 1024
+
 typedef struct gprops_t {
     int is_directed;
     int is_weighted;
@@ -59,27 +73,136 @@ typedef struct components_t {
     int cc_count;
 } components_t;
 
+/**
+ * @brief Scratch memory of the direction-optimizing BFS, reusable between
+ * visits of the same graph.
+ */
+typedef struct bfs_workspace_t {
+    int nvertices;
+    int nvisited;                       // vertices reached by the last visit
+    int *order;                         // vertices in visiting order
+    unsigned long long *frontier;       // bitmap of the current frontier
+    unsigned long long nedges_inspected;// edges inspected by all visits
+    unsigned long long bu_inspected;    // edges inspected by bottom-up steps
+    unsigned long long bu_saved;        // edges a top-down step would inspect
+} bfs_workspace_t;
+
 void print_graph_properties(gprops_t *gp);
 
 void print_graph_overview(matrix_pcsr_t *g, int *degree);
 
+/**
+ * @brief Print an overview of a directed graph, whose diameter is not
+ * computed since the visits of get_diameter assume undirected edges.
+ */
+void print_directed_graph_overview(matrix_pcsr_t *g, int *in_degree,
+                                   int *out_degree);
+
 void BFS_visit(matrix_pcsr_t *g, int *d, int s);
 
 int *DFS_visit(matrix_pcsr_t *g, bool *visited, int s, int *cc_size);
 
+int init_bfs_workspace(bfs_workspace_t *ws, int nvertices);
+
+void free_bfs_workspace(bfs_workspace_t *ws);
+
+/**
+ * @brief Direction-optimizing BFS that switches between top-down and
+ * bottom-up steps as proposed by Beamer et al.
+ *
+ * A top-down step expands the vertices of the frontier, a bottom-up step
+ * searches a parent in the frontier for each unvisited vertex and stops at the
+ * first one found. The switch happens when the edges of the frontier exceed
+ * the edges still unexplored divided by BFS_ALPHA and the visit goes back to
+ * top-down when the frontier has less than nvertices / BFS_BETA vertices.
+ * Bottom-up steps are disabled for the next visits that use the same
+ * workspace as long as they have inspected more edges than the top-down steps
+ * they replaced, as happens on lattice-like graphs.
+ *
+ * @note The bottom-up step uses the rows of the matrix as in-edges, so the
+ * graph must be undirected.
+ * @note Only the entries of d of the visited vertices are written, they are
+ * stored in ws->order for ws->nvisited entries.
+ *
+ * @cite beamer_direction-optimizing_2012
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in, out] d distances from s, initialized to INT_MAX
+ * @param[in] s source vertex
+ * @param[in, out] ws workspace initialized with init_bfs_workspace
+ * @return the distance of the farthest vertex reached
+ */
+int BFS_visit_dir_opt(matrix_pcsr_t *g, int *d, int s, bfs_workspace_t *ws);
+
 /**
  * @brief Get the largest cc and extract a subgraph from it.
  *
  * @param[in] A input disconnected graph
  * @param[out] C output connected graph
  * @param ccs[out] structure that hold ids of the vertices of each cc
+ * @param[in] nthreads number of threads, all available if not positive
  */
 void get_largest_cc(matrix_pcsr_t *A,
                     matrix_pcsr_t *C,
-                    components_t *ccs);
+                    components_t *ccs,
+                    int nthreads);
 
 void get_cc(matrix_pcsr_t *g, components_t *ccs);
 
+/**
+ * @brief Get the connected components with direction-optimizing BFS visits.
+ *
+ * @note Vertices of each cc are stored in BFS order instead of DFS order.
+ *
+ * @param[in] g input undirected graph
+ * @param[out] ccs structure that hold ids of the vertices of each cc
+ * @return 0 if successful, 1 otherwise
+ */
+int get_cc_bfs(matrix_pcsr_t *g, components_t *ccs);
+
+/**
+ * @brief Get the connected components with the Afforest algorithm, a
+ * parallel union-find with lock-free hooking that skips most of the edges
+ * of the largest component @cite sutton_optimizing_2018.
+ *
+ * @note Components are ordered by their smallest vertex, as in get_cc_bfs,
+ * and the vertices of each cc are stored in ascending order.
+ *
+ * @param[in] g input undirected graph
+ * @param[out] ccs structure that hold ids of the vertices of each cc
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int get_cc_afforest(matrix_pcsr_t *g, components_t *ccs, int nthreads);
+
+/**
+ * @brief Get the weakly connected components of a directed graph with the
+ * Afforest algorithm, without skipping the edges of the largest component.
+ *
+ * @note Components and their vertices are ordered as in get_cc_afforest.
+ *
+ * @param[in] g input directed graph
+ * @param[out] ccs structure that hold ids of the vertices of each cc
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int get_wcc(matrix_pcsr_t *g, components_t *ccs, int nthreads);
+
+/**
+ * @brief Get the strongly connected components of a directed graph with
+ * the Tarjan algorithm, without recursion.
+ *
+ * @note Components are stored in reverse topological order of the
+ * condensation of the graph.
+ *
+ * @cite tarjan_depth_1972
+ *
+ * @param[in] g input directed graph
+ * @param[out] ccs structure that hold ids of the vertices of each cc
+ * @return 0 if successful, 1 otherwise
+ */
+int get_scc(matrix_pcsr_t *g, components_t *ccs);
+
 void free_ccs(components_t *ccs);
 
 void extract_subgraph(const int *vertices,
@@ -87,4 +210,45 @@ void extract_subgraph(const int *vertices,
                       matrix_pcsr_t *A,
                       matrix_pcsr_t *C);
 
+/**
+ * @brief Extract the subgraph induced by the given vertices, with the same
+ * result of extract_subgraph.
+ *
+ * Instead of computing R A R^T with SpRef, vertices are relabeled through
+ * an old-to-new id map and the rows of the selected vertices are filtered
+ * in a single pass, in parallel.
+ *
+ * @param[in] vertices sorted ids of the vertices of the subgraph
+ * @param[in] nvertices number of vertices of the subgraph
+ * @param[in] A input graph
+ * @param[out] C induced subgraph, whose i-th vertex is vertices[i]
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int extract_subgraph_relabel(const int *vertices,
+                             int nvertices,
+                             matrix_pcsr_t *A,
+                             matrix_pcsr_t *C,
+                             int nthreads);
+
+/**
+ * @brief Serial variant of extract_subgraph_relabel for extracting many
+ * small subgraphs. The id map is provided by the caller instead of being
+ * allocated and filled for every subgraph, so the cost depends only on the
+ * degrees of the given vertices.
+ *
+ * @param[in] vertices sorted ids of the vertices of the subgraph
+ * @param[in] nvertices number of vertices of the subgraph
+ * @param[in] A input graph
+ * @param[out] C induced subgraph, whose i-th vertex is vertices[i]
+ * @param[in, out] new_id map of A->ncols entries equal to -1, which are
+ * restored before returning
+ * @return 0 if successful, 1 otherwise
+ */
+int extract_subgraph_map(const int *vertices,
+                         int nvertices,
+                         matrix_pcsr_t *A,
+                         matrix_pcsr_t *C,
+                         int *new_id);
+
 #endif//GRAPHS_H
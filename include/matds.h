@@ -42,7 +42,9 @@
 #define MATSTORAGE_H
 
 #include "common.h"
+#include <algorithm>
 #include <cmath>
+#include <omp.h>
 
 typedef struct matrix_pcoo_t {
     int nrows;
@@ -67,6 +69,17 @@ typedef struct matrix_rcsr_t : matrix_pcsr_t {
     int *weights;// value of each entry
 } matrix_rcsr_t;
 
+/*
+ * Read-only CSR whose arrays point into a memory mapped file, which is
+ * shared through the page cache by every process mapping the same file.
+ * It must be released with the function that created it, never with
+ * free_matrix_pcsr.
+ */
+typedef struct matrix_pcsr_view_t : matrix_pcsr_t {
+    void *mapping;     // start of the mapped file
+    size_t mapping_len;// length of the mapping in bytes
+} matrix_pcsr_view_t;
+
 int check_matrix_pcoo(matrix_pcoo_t *matrix);
 
 int check_matrix_pcsr(matrix_pcsr_t *matrix);
@@ -114,6 +127,16 @@ void expand_row_pointer(int nrows, const int *row_offsets, int *rows);
  */
 int coo_to_csr(matrix_pcoo_t *A, matrix_pcsr_t *B);
 
+/**
+ * @brief Computes B = A like coo_to_csr, where A and B hold the weight of
+ * each entry too.
+ *
+ * @param A sparse real matrix in COO format
+ * @param B sparse real matrix in CSR format
+ * @return 0 if successful, 1 otherwise
+ */
+int rcoo_to_rcsr(matrix_rcoo_t *A, matrix_rcsr_t *B);
+
 /**
  * @brief Computes A^T, in which A is an m x n CSR format sparse pattern matrix.
  *
@@ -127,4 +150,42 @@ int coo_to_csr(matrix_pcoo_t *A, matrix_pcsr_t *B);
  */
 int transpose(matrix_pcsr_t *A, matrix_pcsr_t *B);
 
+/**
+ * @brief Replace each element of an array with the sum of the previous
+ * ones, using several threads.
+ *
+ * @param[in, out] a array to be scanned
+ * @param[in] n number of elements of a
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return the sum of all the elements of a
+ */
+int exclusive_scan_par(int *a, int n, int nthreads);
+
+/**
+ * @brief Parallel version of coo_to_csr.
+ *
+ * The entries of A are split in blocks, one per thread, whose row
+ * histograms give the slots where each block scatters its own entries.
+ * Without sorting, the result is the same of coo_to_csr.
+ *
+ * @param A sparse pattern matrix in COO format
+ * @param B sparse pattern matrix in CSR format
+ * @param sort_rows whether to sort the column indices of each row and
+ * merge duplicated entries
+ * @param nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int coo_to_csr_par(matrix_pcoo_t *A, matrix_pcsr_t *B, bool sort_rows,
+                   int nthreads);
+
+/**
+ * @brief Parallel version of transpose, with the same result.
+ *
+ * @param A sparse pattern matrix, can be symmetric or unsymmetric
+ * @param B  the transpose of A
+ * @param nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int transpose_par(matrix_pcsr_t *A, matrix_pcsr_t *B, int nthreads);
+
 #endif// MATSTORAGE_H
@@ -59,11 +59,41 @@
  */
 #define BUFFER_SIZE 1030
 
+/*
+ * Identification of the binary CSR cache files. The version must be
+ * incremented whenever the layout of the file changes.
+ */
+#define CSR_CACHE_MAGIC "SNACSR"
+#define CSR_CACHE_VERSION 1
+#define CSR_CACHE_EXTENSION ".csr"
+
 #include "graphs.h"
 #include "matds.h"
 #include "mmio.h"
 #include <climits>
 #include <cstring>
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Header of a binary CSR cache file. It is followed by nrows + 1 row
+ * offsets and nnz column indices stored as native ints.
+ */
+typedef struct csr_cache_header_t {
+    char magic[8];
+    int version;
+    int byte_order;          // 0x01020304 in the byte order of the writer
+    long long src_size;      // size of the Matrix Market file
+    long long src_mtime_sec; // last modification of the Matrix Market file
+    long long src_mtime_nsec;
+    gprops_t gp;             // properties of the original graph
+    int nrows;
+    int ncols;
+    long long nnz;
+} csr_cache_header_t;
 
 int query_gprops(const char *fname, gprops_t *gp);
 
@@ -83,10 +113,108 @@ int read_mm_pattern(FILE *f, matrix_pcoo_t *m_coo, gprops_t *gp);
 
 int read_mm_real(FILE *f, matrix_rcoo_t *m_coo, gprops_t *gp);
 
-int read_matrix(const char *fname, matrix_pcoo_t *m_coo, gprops_t *gp);
+/**
+ * @brief Reads a pattern matrix like read_mm_pattern, using several
+ * threads.
+ *
+ * The body of the file is mapped in memory and split on line boundaries
+ * in chunks, which are parsed concurrently without the C library and
+ * merged in the order of the file. Comment and blank lines are skipped.
+ *
+ * @param[in] fname name of the Matrix Market file
+ * @param[out] m_coo
+ * @param[in, out] gp properties of the graph, has_self_loops is read and
+ * is_directed is set from the banner
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int read_mm_pattern_par(const char *fname, matrix_pcoo_t *m_coo,
+                        gprops_t *gp, int nthreads);
+
+int read_matrix(const char *fname, matrix_pcoo_t *m_coo, gprops_t *gp,
+                int nthreads);
+
+/**
+ * @brief Reads a weighted graph stored in a Matrix Market file of reals.
+ *
+ * Weights are read as integers, as done by read_mm_real, and the entries of
+ * undirected graphs are stored in both directions with the same weight.
+ *
+ * @param[in] fname name of the Matrix Market file
+ * @param[out] m_coo
+ * @param[in, out] gp properties of the graph, has_self_loops is read and
+ * is_directed must be set by query_gprops
+ * @return 0 if successful, 1 otherwise
+ */
+int read_matrix_real(const char *fname, matrix_rcoo_t *m_coo, gprops_t *gp);
 
 int write_mm_pattern(FILE *f, matrix_pcoo_t *m_coo, bool directed);
 
 int write_mm_real(FILE *f, matrix_rcoo_t *m_coo, bool directed);
 
+/**
+ * @brief Get the name of the cache file of a Matrix Market file.
+ *
+ * @note The returned string uses heap memory.
+ */
+char *get_csr_cache_fname(const char *fname);
+
+/**
+ * @brief Store a graph in CSR format and its properties in a binary cache
+ * file, which is bound to the size and the last modification time of the
+ * Matrix Market file it was read from.
+ *
+ * The file is written under a temporary name and then renamed, so that
+ * concurrent runs never read a partially written cache.
+ *
+ * @param[in] cname name of the cache file
+ * @param[in] fname name of the Matrix Market file
+ * @param[in] g graph to be cached, usually its largest cc
+ * @param[in] gp properties of the graph read from fname
+ * @return 0 if successful, 1 otherwise
+ */
+int write_csr_cache(const char *cname,
+                    const char *fname,
+                    matrix_pcsr_t *g,
+                    gprops_t *gp);
+
+/**
+ * @brief Map a binary cache file in memory without copying it.
+ *
+ * The cache is rejected if its version is not CSR_CACHE_VERSION, if the
+ * Matrix Market file has a different size or modification time than the
+ * one it was created from or if it was created with a different policy
+ * on self loops, given by gp->has_self_loops.
+ *
+ * Pages are read on first access and shared with other processes mapping
+ * the same cache. The arrays of g are read-only and remain valid until
+ * close_csr_cache is called.
+ *
+ * @param[in] cname name of the cache file
+ * @param[in] fname name of the Matrix Market file
+ * @param[out] g read-only graph in CSR format
+ * @param[in, out] gp properties of the graph
+ * @return 0 if successful, 1 if the cache is missing, stale or invalid
+ */
+int open_csr_cache(const char *cname,
+                   const char *fname,
+                   matrix_pcsr_view_t *g,
+                   gprops_t *gp);
+
+/**
+ * @brief Unmap a graph opened by open_csr_cache.
+ */
+void close_csr_cache(matrix_pcsr_view_t *g);
+
+/**
+ * @brief Load a graph from a binary cache file into arrays owned by the
+ * caller, which can be modified and released with free_matrix_pcsr.
+ *
+ * @see open_csr_cache
+ */
+int read_csr_cache(const char *cname,
+                   const char *fname,
+                   matrix_pcsr_t *g,
+                   gprops_t *gp);
+
 #endif//MATIO_H
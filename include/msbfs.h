@@ -0,0 +1,187 @@
+/****************************************************************************
+ * @file msbfs.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Multi-source BFS that advances many sources at once with per-vertex
+ * bitsets and functions to compute closeness centrality and eccentricity with
+ * it.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef MSBFS_H
+#define MSBFS_H
+
+#include "common.h"
+#include "matds.h"
+#include <climits>
+#include <omp.h>
+
+/*
+ * Number of 64 bits words of each bitset, the number of sources visited
+ * together by a multi-source BFS is 64 * MSBFS_WORDS.
+ */
+#define MSBFS_WORDS 4
+#define MSBFS_LANES (64 * MSBFS_WORDS)
+
+typedef unsigned long long lane_t;
+
+/**
+ * @brief Variants of the closeness centrality. The classic one is defined
+ * only on connected graphs, the others stay meaningful when some vertices
+ * are unreachable.
+ */
+enum ClosenessKind {
+    classic_closeness          = 0,// (n - 1) / sum of the distances
+    harmonic_closeness         = 1,// mean of the inverse distances
+    wasserman_faust_closeness  = 2 // classic closeness of the reached
+                                   // vertices, scaled by their fraction
+};
+
+/**
+ * @brief Scratch memory of the multi-source BFS. Each vertex has a bitset of
+ * MSBFS_WORDS words in each array, where bit i is set if the i-th source of
+ * the batch has respectively visited the vertex, has it in its frontier or
+ * has it in its next frontier.
+ */
+typedef struct msbfs_workspace_t {
+    int nvertices;
+    lane_t *seen;
+    lane_t *visit;
+    lane_t *visit_next;
+    unsigned long long dist_sum[MSBFS_LANES];// sum of distances of each source
+    double inv_dist_sum[MSBFS_LANES];        // sum of the inverse distances
+    int nreached[MSBFS_LANES];               // vertices reached by each source
+    int ecc[MSBFS_LANES];                    // eccentricity of each source
+} msbfs_workspace_t;
+
+int init_msbfs_workspace(msbfs_workspace_t *ws, int nvertices);
+
+void free_msbfs_workspace(msbfs_workspace_t *ws);
+
+/**
+ * @brief Visits the graph from the given sources at once as proposed by Then
+ * et al.
+ *
+ * A single scan of the adjacency lists of the vertices in the frontier of any
+ * source serves all the sources of the batch. The sum of the distances,
+ * the number of vertices reached and the eccentricity of the i-th source are
+ * stored at index i of the arrays of the workspace.
+ *
+ * @cite then_more_2014
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in] sources distinct sources of the batch
+ * @param[in] nsources number of sources, at most MSBFS_LANES
+ * @param[in, out] ws workspace initialized with init_msbfs_workspace
+ */
+void msbfs_visit(matrix_pcsr_t *g,
+                 const int *sources,
+                 int nsources,
+                 msbfs_workspace_t *ws);
+
+/**
+ * @brief Computes the closeness centrality of every vertex with a
+ * multi-source BFS for each batch of MSBFS_LANES sources. Batches are
+ * distributed among OpenMP threads.
+ *
+ * @note Scores are identical to the ones of compute_cl_cpu.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] cl array that stores the closeness of each vertex
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_cl_cpu_msbfs(matrix_pcsr_t *g, double *cl, int nthreads);
+
+/**
+ * @brief Computes the closeness centrality of the given sources only, as
+ * compute_cl_cpu_msbfs does for every vertex.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in] sources distinct vertices whose closeness is computed
+ * @param[in] nsources number of sources
+ * @param[out] cl array whose entries of the sources store their closeness
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_cl_cpu_msbfs_sources(matrix_pcsr_t *g,
+                                 const int *sources,
+                                 int nsources,
+                                 double *cl,
+                                 int nthreads);
+
+/**
+ * @brief Computes a variant of the closeness centrality of every vertex, as
+ * compute_cl_cpu_msbfs does for the classic one. Vertices outside the
+ * component of a source are just not counted, so the graph does not need to
+ * be connected.
+ *
+ * The harmonic closeness of v is the sum of 1 / d(v, u) over the other
+ * vertices divided by n - 1. The Wasserman-Faust closeness of v, which
+ * reaches r vertices itself included, is (r - 1)^2 / ((n - 1) * sum of
+ * d(v, u)), or 0 if v is isolated.
+ *
+ * @cite boldi_axioms_2014
+ * @cite wasserman_social_1994
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[in] kind variant of the closeness
+ * @param[out] cl array that stores the closeness of each vertex
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_closeness_cpu_msbfs(matrix_pcsr_t *g,
+                                ClosenessKind kind,
+                                double *cl,
+                                int nthreads);
+
+/**
+ * @brief Get the name of a closeness variant, 0 if the id is not valid.
+ */
+const char *get_closeness_name(ClosenessKind kind);
+
+/**
+ * @brief Get the eccentricity of each vertex with a multi-source BFS for each
+ * batch of MSBFS_LANES sources. Batches are distributed among OpenMP threads.
+ *
+ * @note The eccentricity of a vertex that does not reach every other vertex
+ * is INT_MAX, as in get_vertices_eccentricity.
+ *
+ * @param[in] g input graph in CSR format stored as sparse pattern matrix
+ * @param[out] eccentricity array that stores eccentricity of each vertex
+ * @param[in] nthreads number of threads, if <= 0 the OpenMP default is used
+ * @return 0 if successful, 1 otherwise
+ */
+int get_vertices_eccentricity_msbfs(matrix_pcsr_t *g,
+                                    int *eccentricity,
+                                    int nthreads);
+
+#endif//MSBFS_H
@@ -0,0 +1,126 @@
+/****************************************************************************
+ * @file reorder.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Vertex reordering to improve the locality of accesses to the per-
+ * vertex arrays during graph traversals.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "common.h"
+#include "matds.h"
+#include <algorithm>
+#include <omp.h>
+#include <queue>
+#include <vector>
+
+/*
+ * Size of the window of the last placed vertices whose neighbors and
+ * siblings are favoured by the locality ordering, and maximum degree of a
+ * vertex through which siblings are counted, since hubs would make every
+ * pair of vertices siblings at a quadratic cost.
+ */
+#define GORDER_WINDOW 5
+#define GORDER_MAX_HUB_DEGREE 256
+
+enum ReorderStrategy {
+    no_reorder       = 0,
+    rcm_reorder      = 1,
+    degree_reorder   = 2,
+    locality_reorder = 3
+};
+
+/**
+ * @brief Compute a new id for each vertex of the graph.
+ *
+ * - rcm_reorder: reverse Cuthill-McKee, BFS visits from a low degree
+ * peripheral vertex of each cc that enqueue neighbors by increasing degree,
+ * which reduces the bandwidth of the adjacency matrix;
+ *
+ * - degree_reorder: vertices sorted by decreasing degree, so that the data
+ * of the hubs, accessed by most visits, share few cache lines;
+ *
+ * - locality_reorder: greedy ordering similar to Gorder
+ * @cite wei_speedup_2016, which places next the vertex with the most
+ * neighbors and siblings among the last GORDER_WINDOW placed ones.
+ *
+ * @param[in] g input undirected graph
+ * @param[in] strategy reordering to be used
+ * @param[out] new_id new id of each vertex
+ * @return 0 if successful, 1 otherwise
+ */
+int get_vertex_order(matrix_pcsr_t *g, ReorderStrategy strategy, int *new_id);
+
+/**
+ * @brief Relabel the vertices of a graph, with the column indices of each
+ * row sorted by their new id.
+ *
+ * @param[in] g input graph
+ * @param[in] new_id new id of each vertex
+ * @param[out] h relabeled graph
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int permute_graph(matrix_pcsr_t *g, const int *new_id, matrix_pcsr_t *h,
+                  int nthreads);
+
+/**
+ * @brief Bring scores computed on a relabeled graph back to the original
+ * ids, in place.
+ *
+ * @param[in, out] scores score of each vertex
+ * @param[in] new_id new id of each vertex
+ * @param[in] nvertices number of vertices
+ * @return 0 if successful, 1 otherwise
+ */
+int unpermute_scores(double *scores, const int *new_id, int nvertices);
+
+/**
+ * @brief Bring ids of vertices of a relabeled graph back to the original
+ * ones, in place.
+ *
+ * @param[in, out] ids ids of some vertices
+ * @param[in] nids number of ids
+ * @param[in] new_id new id of each vertex
+ * @param[in] nvertices number of vertices
+ * @return 0 if successful, 1 otherwise
+ */
+int unpermute_ids(int *ids, int nids, const int *new_id, int nvertices);
+
+/**
+ * @brief Get the name of a reordering strategy, 0 if the id is not valid.
+ */
+const char *get_reorder_name(ReorderStrategy strategy);
+
+#endif//REORDER_H
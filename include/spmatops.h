@@ -41,6 +41,7 @@
 
 #include "common.h"
 #include "matds.h"
+#include <cmath>
 
 /**
  * @brief Implements the Gustavson’s row-wise sparse general matrix-matrix
@@ -89,4 +90,106 @@ int get_R_matrix(matrix_pcsr_t *R,
                  int nvertices,
                  int nrows);
 
+/**
+ * @brief Semirings of the products between a sparse pattern matrix and a
+ * block, whose entries of the matrix are ones:
+ *
+ * - plus_times_semiring: (+, *) with identity 0, counts the paths;
+ *
+ * - min_plus_semiring: (min, +) with identity infinity, relaxes the
+ * distances over edges of length one;
+ *
+ * - lor_land_semiring: (or, and) over 0 and 1 with identity 0, finds the
+ * reachable vertices.
+ */
+enum Semiring {
+    plus_times_semiring = 0,
+    min_plus_semiring   = 1,
+    lor_land_semiring   = 2
+};
+
+/**
+ * @brief Block of nrows x nlanes values stored by rows, whose row i holds the
+ * entries of vertex i for nlanes sources, at index i * nlanes + lane.
+ *
+ * Only the rows listed in rows can store entries other than the identity of
+ * the semiring the block is used with, so the products skip the other ones.
+ */
+typedef struct matrix_block_t {
+    int nrows;
+    int nlanes;
+    int nnzrows;    // number of rows listed in rows
+    int *rows;      // rows that store entries, in any order
+    char *listed;   // whether each row is listed in rows
+    double *values;
+} matrix_block_t;
+
+/**
+ * @brief Allocates a block whose entries are all the identity of the
+ * semiring.
+ *
+ * @return 0 if successful, 1 otherwise
+ */
+int init_matrix_block(matrix_block_t *X, int nrows, int nlanes, Semiring sr);
+
+void free_matrix_block(matrix_block_t *X);
+
+/**
+ * @brief Sets the entries of the listed rows back to the identity of the
+ * semiring and empties the list, at a cost proportional to their number.
+ */
+void clear_matrix_block(matrix_block_t *X, Semiring sr);
+
+/**
+ * @brief Appends a row to the list of the rows that store entries, if it is
+ * not there yet.
+ */
+void list_block_row(matrix_block_t *X, int row);
+
+/**
+ * @brief Computes C<M> = C + A' * X over the semiring, pushing the listed
+ * rows of X along the rows of A. Entry (i, j) of C is updated only if
+ * mask[i * nlanes + j] == mask_value, so a single array of levels holds the
+ * masks of every level of a BFS. The rows of C that receive an entry are
+ * listed.
+ *
+ * @note With a symmetric A the product equals A * X. An entry of X equal to
+ * the identity of the semiring is not pushed.
+ *
+ * @param[in] A n x n sparse pattern matrix in CSR format
+ * @param[in] X n x nlanes block
+ * @param[in] mask n x nlanes array, 0 if every entry is updated
+ * @param[in] mask_value value of the entries of the mask to update
+ * @param[in] sr semiring of the product
+ * @param[in, out] C n x nlanes block
+ * @return 0 if successful, 1 otherwise
+ */
+int spmm_t_masked(matrix_pcsr_t *A,
+                  matrix_block_t *X,
+                  const int *mask,
+                  int mask_value,
+                  Semiring sr,
+                  matrix_block_t *C);
+
+/**
+ * @brief Computes C<M> = A * X over the semiring for the listed rows of C
+ * only, each row pulling the rows of X its row of A points to. Entry
+ * (i, j) of C is computed only if mask[i * nlanes + j] == mask_value, the
+ * other ones are set to the identity of the semiring.
+ *
+ * @param[in] A n x n sparse pattern matrix in CSR format
+ * @param[in] X n x nlanes block
+ * @param[in] mask n x nlanes array, 0 if every entry is computed
+ * @param[in] mask_value value of the entries of the mask to compute
+ * @param[in] sr semiring of the product
+ * @param[in, out] C n x nlanes block whose listed rows are computed
+ * @return 0 if successful, 1 otherwise
+ */
+int spmm_masked(matrix_pcsr_t *A,
+                matrix_block_t *X,
+                const int *mask,
+                int mask_value,
+                Semiring sr,
+                matrix_block_t *C);
+
 #endif//SPMATOPS_H
@@ -0,0 +1,110 @@
+/****************************************************************************
+ * @file twins.h
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Compression of structurally equivalent vertices for the exact
+ * betweenness and closeness centrality on the CPU.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#pragma once
+#ifndef TWINS_H
+#define TWINS_H
+
+#include "bc_fold.h"
+#include "bc_statistics.h"
+#include "common.h"
+#include "matds.h"
+#include "msbfs.h"
+#include <omp.h>
+
+/**
+ * @brief Classes of twin vertices of an undirected graph. Two vertices are
+ * false twins if they have the same neighbors and true twins if they also
+ * are adjacent, in both cases swapping them is an automorphism of the graph.
+ */
+typedef struct twins_t {
+    int nvertices;  // vertices of the graph
+    int nclasses;   // number of classes, singletons included
+    int *rep;       // representative of the class of each vertex
+    int *mult;      // size of the class of a representative, 0 otherwise
+} twins_t;
+
+/**
+ * @brief Finds the classes of twins by hashing the set of neighbors of each
+ * vertex, with and without the vertex itself, and by comparing the
+ * adjacency lists of the vertices with the same hash.
+ *
+ * The representative of a class is its vertex with the smallest id.
+ *
+ * @param[in] g input undirected graph without multiple edges and self-loops
+ * @param[out] t classes of twins of g
+ * @return 0 if successful, 1 otherwise
+ */
+int get_twins(matrix_pcsr_t *g, twins_t *t);
+
+void free_twins(twins_t *t);
+
+/**
+ * @brief Computes the exact Betweenness Centrality of an undirected graph by
+ * visiting only the representatives of the classes of twins
+ * @cite sariyuce_shattering_2013.
+ *
+ * Twins have the same dependency on every other vertex and none on each
+ * other, so the dependencies from a representative count once for each
+ * vertex of its class.
+ *
+ * @param[in] g input undirected graph without multiple edges and self-loops
+ * @param[out] bc_scores bc score of each vertex
+ * @param[in] nthreads number of threads, all available if not positive
+ * @param[out] stats runtime of the computation
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_twin_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        int nthreads,
+                        stats_t *stats);
+
+/**
+ * @brief Computes the closeness centrality of an undirected graph by visiting
+ * only the representatives of the classes of twins, whose distances to the
+ * other vertices are the same of their twins.
+ *
+ * @note Scores are identical to the ones of compute_cl_cpu.
+ *
+ * @param[in] g input undirected graph without multiple edges and self-loops
+ * @param[out] cl closeness of each vertex
+ * @param[in] nthreads number of threads, all available if not positive
+ * @return 0 if successful, 1 otherwise
+ */
+int compute_twin_cl_cpu(matrix_pcsr_t *g, double *cl, int nthreads);
+
+#endif//TWINS_H
@@ -95,11 +95,28 @@ void compute_ser_bc_cpu(matrix_pcsr_t *g, double *bc_scores, bool directed) {
             int w = S.top();
             S.pop();
 
-            for (int i = g->row_offsets[w]; i < g->row_offsets[w + 1]; i++) {
-                int v = g->cols[i];
-                if (d[v] == (d[w] - 1)) {
-                    delta[v] +=
-                            (sigma[v] / (float) sigma[w]) * (1.0f + delta[w]);
+            /*
+             * The out-neighbors of a vertex of a directed graph are not its
+             * predecessors, so the vertex pulls the dependencies of its
+             * successors instead, which are already final.
+             */
+            if (directed) {
+                for (int i = g->row_offsets[w]; i < g->row_offsets[w + 1];
+                     i++) {
+                    int x = g->cols[i];
+                    if (d[x] == (d[w] + 1)) {
+                        delta[w] += (sigma[w] / (float) sigma[x]) *
+                                    (1.0f + delta[x]);
+                    }
+                }
+            } else {
+                for (int i = g->row_offsets[w]; i < g->row_offsets[w + 1];
+                     i++) {
+                    int v = g->cols[i];
+                    if (d[v] == (d[w] - 1)) {
+                        delta[v] += (sigma[v] / (float) sigma[w]) *
+                                    (1.0f + delta[w]);
+                    }
                 }
             }
 
@@ -122,3 +139,357 @@ void compute_ser_bc_cpu(matrix_pcsr_t *g, double *bc_scores, bool directed) {
             bc_scores[k] /= 2;
     }
 }
+
+int compute_par_bc_cpu(matrix_pcsr_t *g,
+                       double *bc_scores,
+                       bool directed,
+                       int nthreads) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    /*
+     * Scratch arrays of all the threads, each thread uses a slice of
+     * nvertices elements.
+     */
+    size_t size = (size_t) nthreads * nvertices;
+    auto *sigma = (int *) malloc(size * sizeof(int));
+    auto *d = (int *) malloc(size * sizeof(int));
+    auto *delta = (double *) malloc(size * sizeof(double));
+    auto *order = (int *) malloc(size * sizeof(int));
+
+    if (sigma == 0 || d == 0 || delta == 0 || order == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(sigma);
+        free(d);
+        free(delta);
+        free(order);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < nvertices; i++)
+        bc_scores[i] = 0;
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        int tid = omp_get_thread_num();
+        int nteam = omp_get_num_threads();
+        size_t offset = (size_t) tid * nvertices;
+        int *t_sigma = sigma + offset;
+        int *t_d = d + offset;
+        double *t_delta = delta + offset;
+        int *t_order = order + offset;
+
+        for (int i = 0; i < nvertices; i++) {
+            t_sigma[i] = 0;
+            t_delta[i] = 0.0;
+            t_d[i] = INT_MAX;
+        }
+
+        /*
+         * Each round visits one source per thread, the thread of rank t
+         * taking the source first + t.
+         */
+        for (int first = 0; first < nvertices; first += nteam) {
+
+            int s = first + tid;
+
+            /*
+             * Vertices are appended to the order array as they are
+             * discovered, so the array holds the BFS queue and, when it is
+             * walked backwards, the stack used by the backward propagation.
+             */
+            int head = 0, tail = 0;
+
+            if (s < nvertices) {
+                t_sigma[s] = 1;
+                t_d[s] = 0;
+                t_order[tail++] = s;
+            }
+
+            while (head < tail) {
+
+                int v = t_order[head++];
+
+                for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1];
+                     k++) {
+
+                    int w = g->cols[k];
+
+                    if (t_d[w] == INT_MAX) {
+                        t_order[tail++] = w;
+                        t_d[w] = t_d[v] + 1;
+                    }
+
+                    if (t_d[w] == (t_d[v] + 1)) {
+                        t_sigma[w] += t_sigma[v];
+                    }
+                }
+            }
+
+            for (int i = tail - 1; i >= 0; i--) {
+
+                int w = t_order[i];
+
+                if (directed) {
+                    for (int k = g->row_offsets[w];
+                         k < g->row_offsets[w + 1]; k++) {
+                        int x = g->cols[k];
+                        if (t_d[x] == (t_d[w] + 1)) {
+                            t_delta[w] += (t_sigma[w] / (float) t_sigma[x]) *
+                                          (1.0f + t_delta[x]);
+                        }
+                    }
+                } else {
+                    for (int k = g->row_offsets[w];
+                         k < g->row_offsets[w + 1]; k++) {
+                        int v = g->cols[k];
+                        if (t_d[v] == (t_d[w] - 1)) {
+                            t_delta[v] += (t_sigma[v] / (float) t_sigma[w]) *
+                                          (1.0f + t_delta[w]);
+                        }
+                    }
+                }
+            }
+
+            /*
+             * The source does not add its own dependency.
+             */
+            if (s < nvertices)
+                t_delta[s] = 0.0;
+
+#pragma omp barrier
+
+            /*
+             * The dependencies of the sources of the round are added in
+             * increasing order of source, as in the serial algorithm, each
+             * thread summing a range of vertices. Vertices not reached by
+             * a source add 0, which leaves the scores unchanged.
+             */
+#pragma omp for schedule(static)
+            for (int v = 0; v < nvertices; v++) {
+                for (int t = 0; t < nteam && first + t < nvertices; t++)
+                    bc_scores[v] += delta[(size_t) t * nvertices + v];
+            }
+
+            /*
+             * Reset only the entries reached from this source.
+             */
+            for (int i = 0; i < tail; i++) {
+                int w = t_order[i];
+                t_sigma[w] = 0;
+                t_delta[w] = 0.0;
+                t_d[w] = INT_MAX;
+            }
+        }
+    }
+
+    free(sigma);
+    free(d);
+    free(delta);
+    free(order);
+
+    /*
+     * Scores are duplicated if the graph is undirected because each edge is
+     * counted two times.
+     */
+    if (!directed) {
+        for (int k = 0; k < nvertices; k++)
+            bc_scores[k] /= 2;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void accumulate_ls_dependencies(matrix_pcsr_t *g,
+                                const int *stack,
+                                const int *ends,
+                                int depth,
+                                const int *d,
+                                const unsigned long long *sigma,
+                                double *delta,
+                                double *bc_scores) {
+
+    /*
+     * The vertices of the deepest level have no successors.
+     */
+    for (int i = ends[depth - 1]; i < ends[depth]; i++) {
+        int w = stack[i];
+        delta[w] = 1.0 / (double) sigma[w];
+    }
+
+    /*
+     * Each vertex sums the terms of its successors, which are final since
+     * they belong to the level walked before, and replaces its dependency
+     * by (1 + delta) / sigma. The source needs no dependency.
+     */
+    for (int l = depth - 2; l > 0; l--) {
+        for (int i = ends[l]; i < ends[l + 1]; i++) {
+
+            int w = stack[i];
+            double sum = 0.0;
+
+            for (int k = g->row_offsets[w]; k < g->row_offsets[w + 1]; k++) {
+                int x = g->cols[k];
+                if (d[x] == l + 1)
+                    sum += delta[x];
+            }
+
+            double dep = (double) sigma[w] * sum;
+            bc_scores[w] += dep;
+            delta[w] = (1.0 + dep) / (double) sigma[w];
+        }
+    }
+}
+
+int compute_ls_bc_cpu(matrix_pcsr_t *g,
+                      double *bc_scores,
+                      bool directed,
+                      int nthreads,
+                      stats_t *stats) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    double tstart = get_time();
+    unsigned long long nedges_traversed = 0;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    /*
+     * Scratch arrays and scores of all the threads, each thread uses a
+     * slice of nvertices elements, nvertices + 2 for the level ends since
+     * the end of the empty level after the deepest one is stored too.
+     */
+    size_t size = (size_t) nthreads * nvertices;
+    auto *sigma = (unsigned long long *) malloc(
+            size * sizeof(unsigned long long));
+    auto *d = (int *) malloc(size * sizeof(int));
+    auto *delta = (double *) malloc(size * sizeof(double));
+    auto *t_bc = (double *) calloc(size, sizeof(double));
+    auto *stack = (int *) malloc(size * sizeof(int));
+    auto *ends = (int *) malloc((size + 2 * nthreads) * sizeof(int));
+
+    if (sigma == 0 || d == 0 || delta == 0 || t_bc == 0 || stack == 0 ||
+        ends == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(sigma);
+        free(d);
+        free(delta);
+        free(t_bc);
+        free(stack);
+        free(ends);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nedges_traversed)
+    {
+        size_t offset = (size_t) omp_get_thread_num() * nvertices;
+        unsigned long long *t_sigma = sigma + offset;
+        int *t_d = d + offset;
+        double *t_delta = delta + offset;
+        double *bc = t_bc + offset;
+        int *t_stack = stack + offset;
+        int *t_ends = ends + offset + 2 * omp_get_thread_num();
+
+        for (int i = 0; i < nvertices; i++) {
+            t_sigma[i] = 0;
+            t_d[i] = INT_MAX;
+        }
+
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < nvertices; s++) {
+
+            /*
+             * The vertices at depth l are the ones of the stack between
+             * t_ends[l] and t_ends[l + 1].
+             */
+            int tail = 0, depth = 0;
+
+            t_sigma[s] = 1;
+            t_d[s] = 0;
+            t_stack[tail++] = s;
+            t_ends[0] = 0;
+            t_ends[1] = 1;
+
+            while (t_ends[depth + 1] > t_ends[depth]) {
+
+                for (int i = t_ends[depth]; i < t_ends[depth + 1]; i++) {
+
+                    int v = t_stack[i];
+
+                    for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1];
+                         k++) {
+
+                        int w = g->cols[k];
+
+                        if (t_d[w] == INT_MAX) {
+                            t_stack[tail++] = w;
+                            t_d[w] = depth + 1;
+                        }
+
+                        if (t_d[w] == depth + 1) {
+                            t_sigma[w] += t_sigma[v];
+                        }
+                    }
+                    nedges_traversed +=
+                            g->row_offsets[v + 1] - g->row_offsets[v];
+                }
+
+                depth++;
+                t_ends[depth + 1] = tail;
+            }
+
+            accumulate_ls_dependencies(g, t_stack, t_ends, depth, t_d,
+                                       t_sigma, t_delta, bc);
+
+            /*
+             * Reset only the entries reached from this source, the
+             * dependencies are overwritten by the next one.
+             */
+            for (int i = 0; i < tail; i++) {
+                int w = t_stack[i];
+                t_sigma[w] = 0;
+                t_d[w] = INT_MAX;
+            }
+        }
+
+        /*
+         * Sum the scores of the threads, each one summing a range of
+         * vertices.
+         */
+#pragma omp for schedule(static)
+        for (int v = 0; v < nvertices; v++) {
+            double sum = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                sum += t_bc[(size_t) t * nvertices + v];
+            bc_scores[v] = directed ? sum : sum / 2;
+        }
+    }
+
+    free(sigma);
+    free(d);
+    free(delta);
+    free(t_bc);
+    free(stack);
+    free(ends);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges_traversed;
+    }
+
+    return EXIT_SUCCESS;
+}
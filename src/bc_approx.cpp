@@ -0,0 +1,766 @@
+/****************************************************************************
+ * @file bc_approx.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Functions to approximate the Betweenness Centrality on the CPU by
+ * sampling pivots or shortest paths.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "bc_approx.h"
+
+/**
+ * @brief SplitMix64 generator. Each sample uses its own stream, derived from
+ * the seed and the sample index, so results do not depend on the number of
+ * threads.
+ */
+static inline unsigned long long splitmix64(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Draw a real number in [0, 1).
+ */
+static inline double uniform_real(unsigned long long *state) {
+    return (double) (splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Draw an integer in [0, n).
+ */
+static inline int uniform_int(unsigned long long *state, int n) {
+    return (int) (uniform_real(state) * n);
+}
+
+static inline unsigned long long sample_stream(unsigned long long seed,
+                                               int i) {
+    return seed ^ ((unsigned long long) i * 0xD1B54A32D192ED03ULL);
+}
+
+/**
+ * @brief Scratch arrays of a single thread.
+ */
+typedef struct approx_scratch_t {
+    int *d;
+    unsigned long long *sigma;
+    double *delta;
+    int *order;
+    double *bc;
+} approx_scratch_t;
+
+static int init_scratch(approx_scratch_t *sc, int nvertices) {
+
+    sc->d = (int *) malloc(nvertices * sizeof(int));
+    sc->sigma = (unsigned long long *) calloc(nvertices,
+                                              sizeof(unsigned long long));
+    sc->delta = (double *) calloc(nvertices, sizeof(double));
+    sc->order = (int *) malloc(nvertices * sizeof(int));
+    sc->bc = (double *) calloc(nvertices, sizeof(double));
+
+    if (sc->d == 0 || sc->sigma == 0 || sc->delta == 0 || sc->order == 0 ||
+        sc->bc == 0) {
+        return EXIT_FAILURE;
+    }
+
+    fill(sc->d, nvertices, INT_MAX);
+
+    return EXIT_SUCCESS;
+}
+
+static void free_scratch(approx_scratch_t *sc) {
+    free(sc->d);
+    free(sc->sigma);
+    free(sc->delta);
+    free(sc->order);
+    free(sc->bc);
+}
+
+/**
+ * @brief Visit the graph from s counting shortest paths. If t is not
+ * negative the visit stops at the end of the level where t is discovered.
+ *
+ * @return the number of vertices visited, stored in sc->order
+ */
+static int count_paths(matrix_pcsr_t *g, int s, int t, approx_scratch_t *sc,
+                       unsigned long long *nedges) {
+
+    int *d = sc->d;
+    unsigned long long *sigma = sc->sigma;
+    int *order = sc->order;
+    int head = 0, tail = 0;
+
+    d[s] = 0;
+    sigma[s] = 1;
+    order[tail++] = s;
+
+    while (head < tail) {
+
+        int level_end = tail;
+
+        for (; head < level_end; head++) {
+            int v = order[head];
+
+            for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++) {
+                int w = g->cols[k];
+
+                if (d[w] == INT_MAX) {
+                    order[tail++] = w;
+                    d[w] = d[v] + 1;
+                }
+
+                if (d[w] == (d[v] + 1)) {
+                    sigma[w] += sigma[v];
+                }
+            }
+
+            *nedges += g->row_offsets[v + 1] - g->row_offsets[v];
+        }
+
+        if (t >= 0 && d[t] != INT_MAX)
+            break;
+    }
+
+    return tail;
+}
+
+static void reset_scratch(approx_scratch_t *sc, int nvisited) {
+    for (int i = 0; i < nvisited; i++) {
+        int w = sc->order[i];
+        sc->d[w] = INT_MAX;
+        sc->sigma[w] = 0;
+        sc->delta[w] = 0.0;
+    }
+}
+
+/**
+ * @brief Sum the partial scores of the threads in bc_scores.
+ */
+static void reduce_scratch(approx_scratch_t *sc, int nthreads,
+                           int nvertices, double *bc_scores) {
+    for (int i = 0; i < nvertices; i++)
+        bc_scores[i] = 0;
+
+    for (int t = 0; t < nthreads; t++) {
+        for (int i = 0; i < nvertices; i++)
+            bc_scores[i] += sc[t].bc[i];
+    }
+}
+
+int compute_approx_bc_pivots(matrix_pcsr_t *g,
+                             double *bc_scores,
+                             bool directed,
+                             approx_params_t *p,
+                             double *err_bound,
+                             int nthreads,
+                             stats_t *stats) {
+
+    if (!check_matrix_pcsr(g) || g->nrows < 2) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (p->nsamples <= 0 || p->delta <= 0 || p->delta >= 1) {
+        ZF_LOGF("Invalid sampling parameters");
+        return EXIT_FAILURE;
+    }
+
+    double tstart = get_time();
+    int nvertices = g->nrows;
+    int nnz = g->row_offsets[nvertices];
+    int k = p->nsamples;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *pivots = (int *) malloc(k * sizeof(int));
+    auto *weights = (double *) malloc(k * sizeof(double));
+    auto *sc = (approx_scratch_t *) calloc(nthreads, sizeof(approx_scratch_t));
+
+    if (pivots == 0 || weights == 0 || sc == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(pivots);
+        free(weights);
+        free(sc);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Each pivot is weighted by 1 / (k * p(s)), where p(s) is its probability
+     * of being drawn. The minimum probability bounds the range of a sample.
+     */
+    double p_min = 1.0 / nvertices;
+
+    if (p->pivots == degree_pivots) {
+        int min_degree = INT_MAX;
+        for (int i = 0; i < nvertices; i++) {
+            int degree = g->row_offsets[i + 1] - g->row_offsets[i];
+            if (degree > 0)
+                min_degree = min(min_degree, degree);
+        }
+        p_min = (double) min_degree / nnz;
+    }
+
+    for (int i = 0; i < k; i++) {
+        unsigned long long state = sample_stream(p->seed, i);
+
+        if (p->pivots == degree_pivots) {
+            /*
+             * Row offsets are the cumulative degrees of the vertices.
+             */
+            int r = uniform_int(&state, nnz);
+            int s = (int) (std::upper_bound(g->row_offsets,
+                                            g->row_offsets + nvertices + 1,
+                                            r) -
+                           g->row_offsets) - 1;
+            int degree = g->row_offsets[s + 1] - g->row_offsets[s];
+            pivots[i] = s;
+            weights[i] = (double) nnz / ((double) k * degree);
+        } else {
+            pivots[i] = uniform_int(&state, nvertices);
+            weights[i] = (double) nvertices / k;
+        }
+    }
+
+    int err = EXIT_SUCCESS;
+    unsigned long long nedges = 0;
+    int nchunks = (k + APPROX_PIVOT_CHUNK - 1) / APPROX_PIVOT_CHUNK;
+
+    for (int i = 0; i < nvertices; i++)
+        bc_scores[i] = 0;
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nedges)
+    {
+        approx_scratch_t *t_sc = &sc[omp_get_thread_num()];
+        int t_err = init_scratch(t_sc, nvertices);
+
+        if (t_err) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        }
+
+        /*
+         * The pivots of a chunk are summed in order by a thread, and the
+         * chunks are added to the scores in order, so the additions do not
+         * depend on the scheduling. The ordered region costs O(n) every
+         * APPROX_PIVOT_CHUNK visits.
+         */
+#pragma omp for ordered schedule(dynamic, 1)
+        for (int c = 0; c < nchunks; c++) {
+
+            int last = min(k, (c + 1) * APPROX_PIVOT_CHUNK);
+
+            for (int i = c * APPROX_PIVOT_CHUNK; i < last && !t_err; i++) {
+
+                int s = pivots[i];
+                int nvisited = count_paths(g, s, -1, t_sc, &nedges);
+
+                /*
+                 * The dependencies are pulled from the successors, which
+                 * are the out-neighbours one level deeper, so that the
+                 * arcs of a directed graph are followed forward.
+                 */
+                for (int j = nvisited - 1; j >= 0; j--) {
+                    int w = t_sc->order[j];
+
+                    for (int z = g->row_offsets[w];
+                         z < g->row_offsets[w + 1]; z++) {
+                        int v = g->cols[z];
+                        if (t_sc->d[v] == (t_sc->d[w] + 1)) {
+                            t_sc->delta[w] += ((double) t_sc->sigma[w] /
+                                               (double) t_sc->sigma[v]) *
+                                              (1.0 + t_sc->delta[v]);
+                        }
+                    }
+
+                    if (w != s)
+                        t_sc->bc[w] += weights[i] * t_sc->delta[w];
+                }
+
+                reset_scratch(t_sc, nvisited);
+            }
+
+#pragma omp ordered
+            {
+                if (!t_err) {
+                    for (int v = 0; v < nvertices; v++) {
+                        bc_scores[v] += t_sc->bc[v];
+                        t_sc->bc[v] = 0.0;
+                    }
+                }
+            }
+        }
+    }
+
+    if (err == EXIT_SUCCESS) {
+        /*
+         * A sample of a vertex dependency is at most (n - 2) / p_min.
+         */
+        double range = (nvertices - 2) / p_min;
+        *err_bound = range *
+                     sqrt(log(2.0 * nvertices / p->delta) / (2.0 * k));
+
+        if (!directed) {
+            for (int i = 0; i < nvertices; i++)
+                bc_scores[i] /= 2;
+            *err_bound /= 2;
+        }
+    }
+
+    for (int t = 0; t < nthreads; t++)
+        free_scratch(&sc[t]);
+    free(sc);
+    free(pivots);
+    free(weights);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges;
+    }
+
+    return err;
+}
+
+/**
+ * @brief Upper bound of the vertex diameter. For an undirected connected
+ * graph it is twice the eccentricity of any vertex plus one, otherwise the
+ * number of vertices is used.
+ */
+static int get_vertex_diameter_bound(matrix_pcsr_t *g,
+                                     bool directed,
+                                     int *vertex_diameter) {
+
+    int nvertices = g->nrows;
+    *vertex_diameter = nvertices;
+
+    if (directed)
+        return EXIT_SUCCESS;
+
+    bfs_workspace_t ws;
+    auto *d = (int *) malloc(nvertices * sizeof(int));
+
+    if (d == 0 || init_bfs_workspace(&ws, nvertices)) {
+        ZF_LOGF("Could not allocate memory");
+        free(d);
+        return EXIT_FAILURE;
+    }
+
+    fill(d, nvertices, INT_MAX);
+    int ecc = BFS_visit_dir_opt(g, d, 0, &ws);
+
+    if (ws.nvisited == nvertices)
+        *vertex_diameter = min(nvertices, 2 * ecc + 1);
+
+    free_bfs_workspace(&ws);
+    free(d);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Sample size that guarantees the error bound epsilon with
+ * probability 1 - delta, with the universal constant c = 0.5.
+ *
+ * @return the number of samples, -1 if it does not fit an int
+ */
+static int get_paths_sample_size(int vertex_diameter,
+                                 double epsilon,
+                                 double delta) {
+
+    int vd_log = (vertex_diameter > 2)
+                         ? (int) floor(log2((double) vertex_diameter - 2))
+                         : 0;
+    double r_real = ceil((0.5 / (epsilon * epsilon)) *
+                         (vd_log + 1 + log(1.0 / delta)));
+
+    return (r_real > INT_MAX) ? -1 : (int) r_real;
+}
+
+/**
+ * @brief Allocates the scratch arrays of each thread.
+ *
+ * @return the array of scratches, 0 if the allocation failed
+ */
+static approx_scratch_t *alloc_scratch(int nthreads, int nvertices) {
+
+    auto *sc = (approx_scratch_t *) calloc(nthreads, sizeof(approx_scratch_t));
+    if (sc == 0)
+        return 0;
+
+    int err = EXIT_SUCCESS;
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        if (init_scratch(&sc[omp_get_thread_num()], nvertices)) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        }
+    }
+
+    if (err) {
+        for (int t = 0; t < nthreads; t++)
+            free_scratch(&sc[t]);
+        free(sc);
+        return 0;
+    }
+
+    return sc;
+}
+
+/**
+ * @brief Draws the shortest paths with indices in [first, last) and adds one
+ * to the partial score of each of their inner vertices. The i-th path is
+ * drawn from its own stream, so it does not depend on the number of threads
+ * or on the batches of paths drawn before.
+ *
+ * @param[in] g input graph
+ * @param[in] gt transpose of g, or g itself if undirected
+ */
+static void sample_paths(matrix_pcsr_t *g,
+                         matrix_pcsr_t *gt,
+                         unsigned long long seed,
+                         int first,
+                         int last,
+                         approx_scratch_t *sc,
+                         int nthreads,
+                         unsigned long long *nedges) {
+
+    int nvertices = g->nrows;
+    unsigned long long t_nedges = 0;
+
+#pragma omp parallel for schedule(dynamic, 64) num_threads(nthreads) \
+        reduction(+ : t_nedges)
+    for (int i = first; i < last; i++) {
+
+        approx_scratch_t *t_sc = &sc[omp_get_thread_num()];
+        unsigned long long state = sample_stream(seed, i);
+        int u = uniform_int(&state, nvertices);
+        int v = uniform_int(&state, nvertices - 1);
+        if (v >= u)
+            v++;
+
+        int nvisited = count_paths(g, u, v, t_sc, &t_nedges);
+
+        /*
+         * Walk a random shortest path from v back to u, choosing each
+         * predecessor z of w with probability sigma[z] / sigma[w].
+         */
+        if (t_sc->d[v] != INT_MAX) {
+            int w = v;
+
+            while (w != u) {
+                double target = uniform_real(&state) * t_sc->sigma[w];
+                unsigned long long acc = 0;
+                int z = -1;
+
+                for (int k = gt->row_offsets[w]; k < gt->row_offsets[w + 1];
+                     k++) {
+                    int x = gt->cols[k];
+                    if (t_sc->d[x] == t_sc->d[w] - 1) {
+                        z = x;
+                        acc += t_sc->sigma[x];
+                        if ((double) acc > target)
+                            break;
+                    }
+                }
+
+                if (z != u)
+                    t_sc->bc[z] += 1.0;
+                w = z;
+            }
+        }
+
+        reset_scratch(t_sc, nvisited);
+    }
+
+    *nedges += t_nedges;
+}
+
+int compute_approx_bc_paths(matrix_pcsr_t *g,
+                            double *bc_scores,
+                            bool directed,
+                            approx_params_t *p,
+                            double *err_bound,
+                            int nthreads,
+                            stats_t *stats) {
+
+    if (!check_matrix_pcsr(g) || g->nrows < 2) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (p->epsilon <= 0 || p->epsilon >= 1 || p->delta <= 0 ||
+        p->delta >= 1) {
+        ZF_LOGF("Invalid sampling parameters");
+        return EXIT_FAILURE;
+    }
+
+    double tstart = get_time();
+    int nvertices = g->nrows;
+    int vertex_diameter;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    if (get_vertex_diameter_bound(g, directed, &vertex_diameter))
+        return EXIT_FAILURE;
+
+    int r = get_paths_sample_size(vertex_diameter, p->epsilon, p->delta);
+
+    if (r < 0) {
+        ZF_LOGF("Too many samples required, increase epsilon");
+        return EXIT_FAILURE;
+    }
+
+    ZF_LOGI("Vertex diameter bound: %d, samples: %d", vertex_diameter, r);
+
+    /*
+     * Shortest paths are walked backwards on the in-edges.
+     */
+    matrix_pcsr_t gt = *g;
+    if (directed && transpose_par(g, &gt, nthreads)) {
+        return EXIT_FAILURE;
+    }
+
+    approx_scratch_t *sc = alloc_scratch(nthreads, nvertices);
+    if (sc == 0) {
+        ZF_LOGF("Could not allocate memory");
+        if (directed)
+            free_matrix_pcsr(&gt);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long long nedges = 0;
+    sample_paths(g, &gt, p->seed, 0, r, sc, nthreads, &nedges);
+    reduce_scratch(sc, nthreads, nvertices, bc_scores);
+
+    /*
+     * Normalized scores are relative to the n(n - 1) ordered pairs.
+     */
+    double npairs = (double) nvertices * (nvertices - 1);
+    if (!directed)
+        npairs /= 2;
+
+    for (int i = 0; i < nvertices; i++)
+        bc_scores[i] *= npairs / r;
+    *err_bound = p->epsilon * npairs;
+
+    for (int t = 0; t < nthreads; t++)
+        free_scratch(&sc[t]);
+    free(sc);
+
+    if (directed)
+        free_matrix_pcsr(&gt);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int compute_approx_bc_cpu(matrix_pcsr_t *g,
+                          double *bc_scores,
+                          bool directed,
+                          approx_params_t *p,
+                          double *err_bound,
+                          int nthreads,
+                          stats_t *stats) {
+
+    if (p->nsamples > 0) {
+        return compute_approx_bc_pivots(g, bc_scores, directed, p, err_bound,
+                                        nthreads, stats);
+    } else {
+        return compute_approx_bc_paths(g, bc_scores, directed, p, err_bound,
+                                       nthreads, stats);
+    }
+}
+
+int compute_topk_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        bool directed,
+                        int k,
+                        approx_params_t *p,
+                        int *topk,
+                        double *err_bound,
+                        int nthreads,
+                        stats_t *stats) {
+
+    if (!check_matrix_pcsr(g) || g->nrows < 2) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (k <= 0 || p->epsilon <= 0 || p->epsilon >= 1 || p->delta <= 0 ||
+        p->delta >= 1) {
+        ZF_LOGF("Invalid sampling parameters");
+        return EXIT_FAILURE;
+    }
+
+    double tstart = get_time();
+    int nvertices = g->nrows;
+    int vertex_diameter;
+
+    k = min(k, nvertices);
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    if (get_vertex_diameter_bound(g, directed, &vertex_diameter))
+        return EXIT_FAILURE;
+
+    /*
+     * Half of delta goes to the sample size that bounds the error of every
+     * score by epsilon, half to the checks made after each batch.
+     */
+    int r_max = get_paths_sample_size(vertex_diameter, p->epsilon,
+                                      p->delta / 2);
+
+    if (r_max < 0) {
+        ZF_LOGF("Too many samples required, increase epsilon");
+        return EXIT_FAILURE;
+    }
+
+    matrix_pcsr_t gt = *g;
+    if (directed && transpose_par(g, &gt, nthreads)) {
+        return EXIT_FAILURE;
+    }
+
+    approx_scratch_t *sc = alloc_scratch(nthreads, nvertices);
+    auto *order = (int *) malloc(nvertices * sizeof(int));
+    auto *width = (double *) malloc(nvertices * sizeof(double));
+
+    if (sc == 0 || order == 0 || width == 0) {
+        ZF_LOGF("Could not allocate memory");
+        if (sc != 0) {
+            for (int t = 0; t < nthreads; t++)
+                free_scratch(&sc[t]);
+        }
+        free(sc);
+        free(order);
+        free(width);
+        if (directed)
+            free_matrix_pcsr(&gt);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long long nedges = 0;
+    int r = 0, batch = 0;
+    bool separated = false;
+    double max_width = 1.0;
+
+    while (true) {
+        int next = (r == 0) ? TOPK_FIRST_SAMPLES
+                            : (r > r_max / 2) ? r_max : 2 * r;
+        next = min(next, r_max);
+
+        sample_paths(g, &gt, p->seed, r, next, sc, nthreads, &nedges);
+        reduce_scratch(sc, nthreads, nvertices, bc_scores);
+        r = next;
+        batch++;
+
+        /*
+         * Each score is the mean of r Bernoulli samples, bounded by the
+         * empirical Bernstein inequality with the union bound over the
+         * vertices. The check after the i-th batch fails with probability
+         * at most delta / 2^(i + 1).
+         */
+        double delta_i = p->delta / pow(2.0, batch + 1);
+        double lambda = log(4.0 * nvertices / delta_i);
+        max_width = 0.0;
+
+        for (int v = 0; v < nvertices; v++) {
+            double mean = bc_scores[v] / r;
+            double var = (r > 1) ? mean * (1 - mean) * r / (r - 1) : 0.25;
+            width[v] = sqrt(2 * var * lambda / r) +
+                       7 * lambda / (3.0 * max(r - 1, 1));
+            max_width = std::max(max_width, width[v]);
+            order[v] = v;
+        }
+
+        std::sort(order, order + nvertices, [bc_scores](int a, int b) {
+            return bc_scores[a] > bc_scores[b] ||
+                   (bc_scores[a] == bc_scores[b] && a < b);
+        });
+
+        double lower = 1.0, upper = 0.0;
+        for (int i = 0; i < k; i++) {
+            int v = order[i];
+            lower = std::min(lower, bc_scores[v] / r - width[v]);
+        }
+        for (int i = k; i < nvertices; i++) {
+            int v = order[i];
+            upper = std::max(upper, bc_scores[v] / r + width[v]);
+        }
+
+        separated = (k == nvertices) || lower > upper;
+
+        if (separated || max_width <= p->epsilon || r >= r_max)
+            break;
+    }
+
+    ZF_LOGI("Top-%d vertices %s after %d samples in %d batches", k,
+            separated ? "separated" : "within epsilon", r, batch);
+
+    double npairs = (double) nvertices * (nvertices - 1);
+    if (!directed)
+        npairs /= 2;
+
+    for (int v = 0; v < nvertices; v++)
+        bc_scores[v] *= npairs / r;
+
+    for (int i = 0; i < k; i++)
+        topk[i] = order[i];
+
+    *err_bound = ((r >= r_max) ? std::min(max_width, p->epsilon)
+                               : max_width) * npairs;
+
+    for (int t = 0; t < nthreads; t++)
+        free_scratch(&sc[t]);
+    free(sc);
+    free(order);
+    free(width);
+
+    if (directed)
+        free_matrix_pcsr(&gt);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,309 @@
+/****************************************************************************
+ * @file bc_batch.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Batched Brandes algorithm that computes the Betweenness Centrality
+ * from many sources per traversal on the CPU.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "bc_batch.h"
+
+/*
+ * The per-source loops are compiled for AVX-512, AVX2 and the baseline
+ * instruction set, and the widest one supported by the CPU is picked at
+ * load time.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define BATCH_TARGETS __attribute__((target_clones("avx512f", "avx2", \
+                                                   "default")))
+#else
+#define BATCH_TARGETS
+#endif
+
+int init_batch_workspace(batch_workspace_t *ws, int nvertices) {
+
+    size_t size = (size_t) nvertices * BATCH_LANES;
+
+    ws->nvertices = nvertices;
+    ws->d = (int *) malloc(size * sizeof(int));
+    ws->sigma = (double *) calloc(size, sizeof(double));
+    ws->delta = (double *) calloc(size, sizeof(double));
+    ws->stack = (int *) malloc(size * sizeof(int));
+    ws->ends = (int *) malloc((nvertices + 2) * sizeof(int));
+    ws->level = (int *) malloc(nvertices * sizeof(int));
+
+    if (ws->d == 0 || ws->sigma == 0 || ws->delta == 0 || ws->stack == 0 ||
+        ws->ends == 0 || ws->level == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_batch_workspace(ws);
+        return EXIT_FAILURE;
+    }
+
+    fill(ws->d, (int) size, INT_MAX);
+    fill(ws->level, nvertices, -1);
+
+    return EXIT_SUCCESS;
+}
+
+void free_batch_workspace(batch_workspace_t *ws) {
+    free(ws->d);
+    free(ws->sigma);
+    free(ws->delta);
+    free(ws->stack);
+    free(ws->ends);
+    free(ws->level);
+    ws->d = 0;
+    ws->sigma = 0;
+    ws->delta = 0;
+    ws->stack = 0;
+    ws->ends = 0;
+    ws->level = 0;
+    ws->nvertices = 0;
+}
+
+BATCH_TARGETS
+unsigned long long batch_bc_visit(matrix_pcsr_t *g,
+                                  const int *sources,
+                                  int nsources,
+                                  batch_workspace_t *ws,
+                                  double *bc_scores) {
+
+    const int *row_offsets = g->row_offsets;
+    const int *cols = g->cols;
+    int *d = ws->d;
+    double *sigma = ws->sigma;
+    double *delta = ws->delta;
+    int *stack = ws->stack;
+    int *ends = ws->ends;
+    int *level = ws->level;
+    unsigned long long nedges_traversed = 0;
+
+    int tail = 0, depth = 0;
+
+    for (int j = 0; j < nsources; j++) {
+        int s = sources[j];
+        d[(size_t) s * BATCH_LANES + j] = 0;
+        sigma[(size_t) s * BATCH_LANES + j] = 1.0;
+        level[s] = 0;
+        stack[tail++] = s;
+    }
+    ends[0] = 0;
+    ends[1] = tail;
+
+    /*
+     * A vertex of the level is expanded for the sources it is at distance
+     * depth from, and a neighbor discovered by any of them joins the next
+     * level once.
+     */
+    while (ends[depth + 1] > ends[depth]) {
+
+        for (int i = ends[depth]; i < ends[depth + 1]; i++) {
+
+            int v = stack[i];
+            const int *d_v = d + (size_t) v * BATCH_LANES;
+            const double *sigma_v = sigma + (size_t) v * BATCH_LANES;
+
+            /*
+             * The sources v is not at distance depth from add no paths
+             * and discover no vertices.
+             */
+            int active[BATCH_LANES];
+            double paths[BATCH_LANES];
+
+#pragma omp simd
+            for (int j = 0; j < BATCH_LANES; j++) {
+                active[j] = d_v[j] == depth;
+                paths[j] = active[j] ? sigma_v[j] : 0.0;
+            }
+
+            for (int k = row_offsets[v]; k < row_offsets[v + 1]; k++) {
+
+                int w = cols[k];
+                int *d_w = d + (size_t) w * BATCH_LANES;
+                double *sigma_w = sigma + (size_t) w * BATCH_LANES;
+                int found = 0;
+
+#pragma omp simd reduction(| : found)
+                for (int j = 0; j < BATCH_LANES; j++) {
+                    int discovered = active[j] & (d_w[j] == INT_MAX);
+                    int d_new = discovered ? depth + 1 : d_w[j];
+                    d_w[j] = d_new;
+                    sigma_w[j] += (d_new == depth + 1) ? paths[j] : 0.0;
+                    found |= discovered;
+                }
+
+                if (found && level[w] != depth + 1) {
+                    level[w] = depth + 1;
+                    stack[tail++] = w;
+                }
+            }
+            nedges_traversed += row_offsets[v + 1] - row_offsets[v];
+        }
+
+        depth++;
+        ends[depth + 1] = tail;
+    }
+
+    /*
+     * Each vertex pulls the terms of its successors for the sources it is
+     * at distance l from, then stores (1 + delta) / sigma for its own
+     * predecessors. The sources need no dependency.
+     */
+    for (int l = depth - 1; l > 0; l--) {
+        for (int i = ends[l]; i < ends[l + 1]; i++) {
+
+            int w = stack[i];
+            const int *d_w = d + (size_t) w * BATCH_LANES;
+            const double *sigma_w = sigma + (size_t) w * BATCH_LANES;
+            double *delta_w = delta + (size_t) w * BATCH_LANES;
+            double sum[BATCH_LANES] = {0.0};
+
+            /*
+             * The vertices of the deepest level have no successors.
+             */
+            for (int k = row_offsets[w];
+                 l < depth - 1 && k < row_offsets[w + 1]; k++) {
+
+                int x = cols[k];
+                const int *d_x = d + (size_t) x * BATCH_LANES;
+                const double *delta_x = delta + (size_t) x * BATCH_LANES;
+
+#pragma omp simd
+                for (int j = 0; j < BATCH_LANES; j++) {
+                    sum[j] += (d_w[j] == l && d_x[j] == l + 1)
+                              ? delta_x[j] : 0.0;
+                }
+            }
+
+            double dep_sum = 0.0;
+
+#pragma omp simd reduction(+ : dep_sum)
+            for (int j = 0; j < BATCH_LANES; j++) {
+                bool active = d_w[j] == l;
+                double dep = active ? sigma_w[j] * sum[j] : 0.0;
+                dep_sum += dep;
+                delta_w[j] = active ? (1.0 + dep) / sigma_w[j] : delta_w[j];
+            }
+
+            bc_scores[w] += dep_sum;
+        }
+    }
+
+    /*
+     * Reset only the vertices reached from the batch, the dependencies are
+     * overwritten by the next one.
+     */
+    for (int i = 0; i < tail; i++) {
+        int w = stack[i];
+        for (int j = 0; j < BATCH_LANES; j++) {
+            d[(size_t) w * BATCH_LANES + j] = INT_MAX;
+            sigma[(size_t) w * BATCH_LANES + j] = 0.0;
+        }
+        level[w] = -1;
+    }
+
+    return nedges_traversed;
+}
+
+int compute_batch_bc_cpu(matrix_pcsr_t *g,
+                         double *bc_scores,
+                         bool directed,
+                         int nthreads,
+                         stats_t *stats) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    int nbatches = (nvertices + BATCH_LANES - 1) / BATCH_LANES;
+    double tstart = get_time();
+    unsigned long long nedges_traversed = 0;
+    int err = EXIT_SUCCESS;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *t_bc = (double *) calloc((size_t) nthreads * nvertices,
+                                   sizeof(double));
+    if (t_bc == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nedges_traversed)
+    {
+        double *bc = t_bc + (size_t) omp_get_thread_num() * nvertices;
+        batch_workspace_t ws;
+        int t_err = init_batch_workspace(&ws, nvertices);
+
+#pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < nbatches; b++) {
+
+            if (t_err)
+                continue;
+
+            int first = b * BATCH_LANES;
+            int nsources = min(BATCH_LANES, nvertices - first);
+            int sources[BATCH_LANES];
+
+            for (int j = 0; j < nsources; j++)
+                sources[j] = first + j;
+
+            nedges_traversed += batch_bc_visit(g, sources, nsources, &ws, bc);
+        }
+
+        if (t_err) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        }
+        free_batch_workspace(&ws);
+    }
+
+    if (err == EXIT_SUCCESS) {
+        for (int v = 0; v < nvertices; v++) {
+            double sum = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                sum += t_bc[(size_t) t * nvertices + v];
+            bc_scores[v] = directed ? sum : sum / 2;
+        }
+    }
+    free(t_bc);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges_traversed;
+    }
+
+    return err;
+}
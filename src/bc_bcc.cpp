@@ -0,0 +1,353 @@
+/****************************************************************************
+ * @file bc_bcc.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Implementation of the Hopcroft-Tarjan decomposition and of the
+ * block-wise betweenness centrality.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include "bc_bcc.h"
+
+int get_blocks(matrix_pcsr_t *g, blocks_t *b) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    auto *disc = (int *) malloc(nvertices * sizeof(int));
+    auto *low = (int *) malloc(nvertices * sizeof(int));
+    auto *parent = (int *) malloc(nvertices * sizeof(int));
+    auto *next = (int *) malloc(nvertices * sizeof(int));
+    auto *sub = (int *) malloc(nvertices * sizeof(int));
+    auto *nchildren = (int *) calloc(nvertices, sizeof(int));
+    auto *calls = (int *) malloc(nvertices * sizeof(int));
+    auto *stack = (int *) malloc(nvertices * sizeof(int));
+    auto *visited = (int *) malloc(nvertices * sizeof(int));
+
+    /*
+     * There are less blocks than vertices and each vertex appears in the
+     * blocks below it only once, plus once for each block it is the top of.
+     */
+    b->nvertices = nvertices;
+    b->nblocks = 0;
+    b->offsets = (int *) malloc((nvertices + 1) * sizeof(int));
+    b->vertices = (int *) malloc(2 * (size_t) nvertices * sizeof(int));
+    b->top = (int *) malloc(nvertices * sizeof(int));
+    b->below = (int *) malloc(nvertices * sizeof(int));
+    b->cc_size = (int *) malloc(nvertices * sizeof(int));
+    b->is_cut = (bool *) malloc(nvertices * sizeof(bool));
+
+    if (disc == 0 || low == 0 || parent == 0 || next == 0 || sub == 0 ||
+        nchildren == 0 || calls == 0 || stack == 0 || visited == 0 ||
+        b->offsets == 0 || b->vertices == 0 || b->top == 0 ||
+        b->below == 0 || b->cc_size == 0 || b->is_cut == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(disc);
+        free(low);
+        free(parent);
+        free(next);
+        free(sub);
+        free(nchildren);
+        free(calls);
+        free(stack);
+        free(visited);
+        free_blocks(b);
+        return EXIT_FAILURE;
+    }
+
+    for (int v = 0; v < nvertices; v++)
+        disc[v] = -1;
+
+    int time = 0, nvisited = 0, nentries = 0;
+    b->offsets[0] = 0;
+
+    for (int r = 0; r < nvertices; r++) {
+        if (disc[r] != -1)
+            continue;
+
+        int first = nvisited, ncalls = 0, height = 0;
+
+        disc[r] = low[r] = time++;
+        parent[r] = -1;
+        next[r] = g->row_offsets[r];
+        sub[r] = 1;
+        visited[nvisited++] = r;
+        calls[ncalls++] = r;
+        stack[height++] = r;
+
+        /*
+         * The recursion is unrolled on an explicit stack of calls, so that
+         * long paths do not overflow the call stack.
+         */
+        while (ncalls > 0) {
+            int v = calls[ncalls - 1];
+
+            if (next[v] < g->row_offsets[v + 1]) {
+                int w = g->cols[next[v]++];
+
+                if (disc[w] == -1) {
+                    disc[w] = low[w] = time++;
+                    parent[w] = v;
+                    next[w] = g->row_offsets[w];
+                    sub[w] = 1;
+                    visited[nvisited++] = w;
+                    calls[ncalls++] = w;
+                    stack[height++] = w;
+                } else if (w != parent[v]) {
+                    low[v] = min(low[v], disc[w]);
+                }
+                continue;
+            }
+
+            ncalls--;
+            int p = parent[v];
+            if (p < 0)
+                continue;
+
+            sub[p] += sub[v];
+            low[p] = min(low[p], low[v]);
+
+            /*
+             * Nothing below v reaches above p, so p and the vertices left on
+             * the stack down to v form a block.
+             */
+            if (low[v] >= disc[p]) {
+                int w;
+                do {
+                    w = stack[--height];
+                    b->vertices[nentries++] = w;
+                } while (w != v);
+                b->vertices[nentries++] = p;
+
+                b->top[b->nblocks] = p;
+                b->below[b->nblocks] = sub[v];
+                b->nblocks++;
+                b->offsets[b->nblocks] = nentries;
+                nchildren[p]++;
+            }
+        }
+
+        for (int i = first; i < nvisited; i++)
+            b->cc_size[visited[i]] = sub[r];
+    }
+
+    /*
+     * The root of a search is an articulation point only if it has more than
+     * one child, the other vertices if any child cannot go around them.
+     */
+    for (int v = 0; v < nvertices; v++)
+        b->is_cut[v] = nchildren[v] > ((parent[v] < 0) ? 1 : 0);
+
+    for (int i = 0; i < b->nblocks; i++)
+        std::sort(b->vertices + b->offsets[i],
+                  b->vertices + b->offsets[i + 1]);
+
+    free(disc);
+    free(low);
+    free(parent);
+    free(next);
+    free(sub);
+    free(nchildren);
+    free(calls);
+    free(stack);
+    free(visited);
+
+    return EXIT_SUCCESS;
+}
+
+void free_blocks(blocks_t *b) {
+    free(b->offsets);
+    free(b->vertices);
+    free(b->top);
+    free(b->below);
+    free(b->cc_size);
+    free(b->is_cut);
+    b->offsets = 0;
+    b->vertices = 0;
+    b->top = 0;
+    b->below = 0;
+    b->cc_size = 0;
+    b->is_cut = 0;
+}
+
+/**
+ * @brief Runs the weighted Brandes algorithm on a block and adds the scores
+ * of its vertices to the ones of the graph.
+ */
+static int add_block_bc(matrix_pcsr_t *block,
+                        const int *vertices,
+                        const int *weight,
+                        double *bc_scores,
+                        int nthreads) {
+
+    auto *block_bc = (double *) malloc(block->nrows * sizeof(double));
+
+    if (block_bc == 0 ||
+        compute_weighted_bc_cpu(block, weight, block_bc, nthreads)) {
+        free(block_bc);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < block->nrows; i++) {
+#pragma omp atomic
+        bc_scores[vertices[i]] += block_bc[i];
+    }
+
+    free(block_bc);
+
+    return EXIT_SUCCESS;
+}
+
+int compute_bcc_bc_cpu(matrix_pcsr_t *g,
+                       double *bc_scores,
+                       int nthreads,
+                       stats_t *stats) {
+
+    double tstart = get_time();
+    blocks_t b;
+
+    if (get_blocks(g, &b))
+        return EXIT_FAILURE;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int nvertices = g->nrows;
+    auto *hang = (int *) calloc(nvertices, sizeof(int));
+    auto *sum_sq = (double *) calloc(nvertices, sizeof(double));
+    auto *new_id = (int *) malloc(nvertices * sizeof(int));
+    auto *weight = (int *) malloc(max(b.offsets[b.nblocks], 1) * sizeof(int));
+    auto *blocks = (matrix_pcsr_t *) calloc(b.nblocks + 1,
+                                            sizeof(matrix_pcsr_t));
+
+    if (hang == 0 || sum_sq == 0 || new_id == 0 || weight == 0 ||
+        blocks == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(hang);
+        free(sum_sq);
+        free(new_id);
+        free(weight);
+        free(blocks);
+        free_blocks(&b);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < b.nblocks; i++) {
+        double below = b.below[i];
+        hang[b.top[i]] += b.below[i];
+        sum_sq[b.top[i]] += below * below;
+    }
+
+    /*
+     * Pairs split by v, between the subtrees of the blocks it is the top of
+     * and the rest of its connected component.
+     */
+    for (int v = 0; v < nvertices; v++) {
+        double n = b.cc_size[v];
+        double rest = n - 1 - hang[v];
+        bc_scores[v] = ((n - 1) * (n - 1) - sum_sq[v] - rest * rest) / 2;
+        new_id[v] = -1;
+    }
+
+    /*
+     * The top vertex of a block stands for everything above it, the others
+     * for themselves and the subtrees of the blocks below them.
+     */
+    int nlarge = 0, nsmall = 0, err = 0;
+    unsigned long long nedges_traversed = 0;
+
+    for (int i = 0; i < b.nblocks && !err; i++) {
+        int start = b.offsets[i];
+        int size = b.offsets[i + 1] - start;
+
+        if (size < 3)
+            continue;
+
+        for (int j = start; j < b.offsets[i + 1]; j++) {
+            int u = b.vertices[j];
+            weight[j] = (u == b.top[i]) ? b.cc_size[u] - b.below[i]
+                                        : 1 + hang[u];
+        }
+
+        err = extract_subgraph_map(b.vertices + start, size, g, &blocks[i],
+                                   new_id);
+        nedges_traversed += (unsigned long long) blocks[i].nrows *
+                            blocks[i].row_offsets[blocks[i].nrows];
+
+        if (size >= BCC_LARGE_BLOCK)
+            nlarge++;
+        else
+            nsmall++;
+    }
+
+    ZF_LOGI("Found %d blocks, %d with more than two vertices", b.nblocks,
+            nlarge + nsmall);
+
+    for (int i = 0; i < b.nblocks && !err; i++) {
+        if (blocks[i].nrows >= BCC_LARGE_BLOCK)
+            err = add_block_bc(&blocks[i], b.vertices + b.offsets[i],
+                               weight + b.offsets[i], bc_scores, nthreads);
+    }
+
+    if (!err) {
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads) \
+        reduction(|: err)
+        for (int i = 0; i < b.nblocks; i++) {
+            if (blocks[i].nrows >= 3 && blocks[i].nrows < BCC_LARGE_BLOCK)
+                err |= add_block_bc(&blocks[i], b.vertices + b.offsets[i],
+                                    weight + b.offsets[i], bc_scores, 1);
+        }
+    }
+
+    if (err)
+        ZF_LOGF("Could not compute the betweenness of the blocks");
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges_traversed;
+    }
+
+    for (int i = 0; i < b.nblocks; i++)
+        free_matrix_pcsr(&blocks[i]);
+
+    free(hang);
+    free(sum_sq);
+    free(new_id);
+    free(weight);
+    free(blocks);
+    free_blocks(&b);
+
+    return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,329 @@
+/****************************************************************************
+ * @file bc_fold.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Implementation of the degree-one folding and of the weighted Brandes
+ * algorithm.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "bc_fold.h"
+
+int fold_degree_one(matrix_pcsr_t *g, fold_t *f) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    auto *degree = (int *) malloc(nvertices * sizeof(int));
+    auto *queue = (int *) malloc(nvertices * sizeof(int));
+    auto *removed = (bool *) calloc(nvertices, sizeof(bool));
+
+    f->nvertices = nvertices;
+    f->weight = (int *) malloc(nvertices * sizeof(int));
+    f->sum_sq = (double *) calloc(nvertices, sizeof(double));
+    f->core = (int *) malloc(nvertices * sizeof(int));
+
+    if (degree == 0 || queue == 0 || removed == 0 || f->weight == 0 ||
+        f->sum_sq == 0 || f->core == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(degree);
+        free(queue);
+        free(removed);
+        free_fold(f);
+        return EXIT_FAILURE;
+    }
+
+    int head = 0, tail = 0;
+    for (int v = 0; v < nvertices; v++) {
+        degree[v] = g->row_offsets[v + 1] - g->row_offsets[v];
+        f->weight[v] = 1;
+        if (degree[v] == 1)
+            queue[tail++] = v;
+    }
+
+    /*
+     * Fold leaves into their neighbor, which may become a leaf in turn.
+     */
+    int nleft = nvertices;
+    while (head < tail && nleft > 1) {
+        int u = queue[head++];
+        if (degree[u] != 1)
+            continue;
+
+        int p = -1;
+        for (int k = g->row_offsets[u]; k < g->row_offsets[u + 1]; k++) {
+            if (!removed[g->cols[k]]) {
+                p = g->cols[k];
+                break;
+            }
+        }
+
+        removed[u] = true;
+        degree[u] = 0;
+        nleft--;
+
+        f->weight[p] += f->weight[u];
+        f->sum_sq[p] += (double) f->weight[u] * f->weight[u];
+
+        if (--degree[p] == 1)
+            queue[tail++] = p;
+    }
+
+    f->ncore = 0;
+    for (int v = 0; v < nvertices; v++) {
+        if (!removed[v])
+            f->core[f->ncore++] = v;
+    }
+
+    free(degree);
+    free(queue);
+    free(removed);
+
+    return EXIT_SUCCESS;
+}
+
+void free_fold(fold_t *f) {
+    free(f->core);
+    free(f->weight);
+    free(f->sum_sq);
+    f->core = 0;
+    f->weight = 0;
+    f->sum_sq = 0;
+}
+
+/**
+ * @brief Weighted Brandes algorithm where each target w counts for weight[w]
+ * vertices, or one if weight is 0, and each source s for mult[s] sources.
+ */
+static int weighted_brandes(matrix_pcsr_t *g,
+                            const int *weight,
+                            const int *mult,
+                            double *bc_scores,
+                            int nthreads) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    /*
+     * Path counts are kept as doubles, like the dependencies, since they
+     * overflow integers on large graphs.
+     */
+    size_t size = (size_t) nthreads * nvertices;
+    auto *sigma = (double *) malloc(size * sizeof(double));
+    auto *d = (int *) malloc(size * sizeof(int));
+    auto *delta = (double *) malloc(size * sizeof(double));
+    auto *order = (int *) malloc(size * sizeof(int));
+    auto *partial = (double *) calloc(size, sizeof(double));
+
+    if (sigma == 0 || d == 0 || delta == 0 || order == 0 || partial == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(sigma);
+        free(d);
+        free(delta);
+        free(order);
+        free(partial);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        size_t offset = (size_t) omp_get_thread_num() * nvertices;
+        double *t_sigma = sigma + offset;
+        int *t_d = d + offset;
+        double *t_delta = delta + offset;
+        int *t_order = order + offset;
+        double *t_bc = partial + offset;
+
+        for (int i = 0; i < nvertices; i++) {
+            t_sigma[i] = 0.0;
+            t_delta[i] = 0.0;
+            t_d[i] = INT_MAX;
+        }
+
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < nvertices; s++) {
+
+            if (mult[s] == 0)
+                continue;
+
+            int head = 0, tail = 0;
+
+            t_sigma[s] = 1.0;
+            t_d[s] = 0;
+            t_order[tail++] = s;
+
+            while (head < tail) {
+                int v = t_order[head++];
+
+                for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1];
+                     k++) {
+                    int w = g->cols[k];
+
+                    if (t_d[w] == INT_MAX) {
+                        t_order[tail++] = w;
+                        t_d[w] = t_d[v] + 1;
+                    }
+
+                    if (t_d[w] == t_d[v] + 1)
+                        t_sigma[w] += t_sigma[v];
+                }
+            }
+
+            /*
+             * Each target w counts for the weight[w] vertices it stands for.
+             */
+            for (int i = tail - 1; i > 0; i--) {
+                int w = t_order[i];
+                int w_weight = (weight != 0) ? weight[w] : 1;
+                double coeff = (w_weight + t_delta[w]) / t_sigma[w];
+
+                for (int k = g->row_offsets[w]; k < g->row_offsets[w + 1];
+                     k++) {
+                    int v = g->cols[k];
+                    if (t_d[v] == t_d[w] - 1)
+                        t_delta[v] += t_sigma[v] * coeff;
+                }
+
+                t_bc[w] += mult[s] * t_delta[w];
+            }
+
+            for (int i = 0; i < tail; i++) {
+                int w = t_order[i];
+                t_sigma[w] = 0.0;
+                t_delta[w] = 0.0;
+                t_d[w] = INT_MAX;
+            }
+        }
+
+        /*
+         * Undirected pairs are counted from both endpoints.
+         */
+#pragma omp for schedule(static)
+        for (int v = 0; v < nvertices; v++) {
+            double score = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                score += partial[(size_t) t * nvertices + v];
+            bc_scores[v] = score / 2;
+        }
+    }
+
+    free(sigma);
+    free(d);
+    free(delta);
+    free(order);
+    free(partial);
+
+    return EXIT_SUCCESS;
+}
+
+int compute_weighted_bc_cpu(matrix_pcsr_t *g,
+                            const int *weight,
+                            double *bc_scores,
+                            int nthreads) {
+    return weighted_brandes(g, weight, weight, bc_scores, nthreads);
+}
+
+int compute_multi_source_bc_cpu(matrix_pcsr_t *g,
+                                const int *mult,
+                                double *bc_scores,
+                                int nthreads) {
+    return weighted_brandes(g, 0, mult, bc_scores, nthreads);
+}
+
+int compute_folded_bc_cpu(matrix_pcsr_t *g,
+                          double *bc_scores,
+                          int nthreads,
+                          stats_t *stats) {
+
+    double tstart = get_time();
+    fold_t f;
+    matrix_pcsr_t core;
+
+    if (fold_degree_one(g, &f))
+        return EXIT_FAILURE;
+
+    ZF_LOGI("Folded %d of %d vertices with degree one",
+            f.nvertices - f.ncore, f.nvertices);
+
+    auto *core_weight = (int *) malloc(f.ncore * sizeof(int));
+    auto *core_bc = (double *) malloc(f.ncore * sizeof(double));
+
+    if (core_weight == 0 || core_bc == 0 ||
+        extract_subgraph_relabel(f.core, f.ncore, g, &core, nthreads)) {
+        ZF_LOGF("Could not build the core of the graph");
+        free(core_weight);
+        free(core_bc);
+        free_fold(&f);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < f.ncore; i++)
+        core_weight[i] = f.weight[f.core[i]];
+
+    int err = compute_weighted_bc_cpu(&core, core_weight, core_bc, nthreads);
+
+    if (!err) {
+        /*
+         * Pairs split by v, with one endpoint in a subtree folded into it.
+         */
+        double n = f.nvertices;
+        for (int v = 0; v < f.nvertices; v++) {
+            double rest = n - f.weight[v];
+            bc_scores[v] = ((n - 1) * (n - 1) - f.sum_sq[v] - rest * rest) / 2;
+        }
+
+        for (int i = 0; i < f.ncore; i++)
+            bc_scores[f.core[i]] += core_bc[i];
+    }
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = (unsigned long long) core.nrows *
+                                  core.row_offsets[core.nrows];
+    }
+
+    free(core_weight);
+    free(core_bc);
+    free_matrix_pcsr(&core);
+    free_fold(&f);
+
+    return err;
+}
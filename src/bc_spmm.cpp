@@ -0,0 +1,284 @@
+/****************************************************************************
+ * @file bc_spmm.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Betweenness Centrality on the CPU expressed with masked sparse matrix
+ * products over semirings.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "bc_spmm.h"
+
+/**
+ * @brief Blocks and arrays of a thread, each n x SPMM_BC_LANES but the
+ * rows of the levels and their ends.
+ */
+typedef struct spmm_bc_workspace_t {
+    matrix_block_t sigma;
+    matrix_block_t frontier;
+    matrix_block_t next;
+    int *level;
+    int *stack;
+    int *ends;
+} spmm_bc_workspace_t;
+
+static void free_spmm_bc_workspace(spmm_bc_workspace_t *ws) {
+    free_matrix_block(&ws->sigma);
+    free_matrix_block(&ws->frontier);
+    free_matrix_block(&ws->next);
+    free(ws->level);
+    free(ws->stack);
+    free(ws->ends);
+    ws->level = 0;
+    ws->stack = 0;
+    ws->ends = 0;
+}
+
+static int init_spmm_bc_workspace(spmm_bc_workspace_t *ws, int nvertices) {
+
+    size_t size = (size_t) nvertices * SPMM_BC_LANES;
+
+    ws->level = (int *) malloc(size * sizeof(int));
+    ws->stack = (int *) malloc(size * sizeof(int));
+    ws->ends = (int *) malloc((nvertices + 2) * sizeof(int));
+
+    if (init_matrix_block(&ws->sigma, nvertices, SPMM_BC_LANES,
+                          plus_times_semiring) ||
+        init_matrix_block(&ws->frontier, nvertices, SPMM_BC_LANES,
+                          plus_times_semiring) ||
+        init_matrix_block(&ws->next, nvertices, SPMM_BC_LANES,
+                          plus_times_semiring) ||
+        ws->level == 0 || ws->stack == 0 || ws->ends == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_spmm_bc_workspace(ws);
+        return EXIT_FAILURE;
+    }
+
+    fill(ws->level, (int) size, INT_MAX);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Adds to bc_scores the dependencies of the sources first, ...,
+ * first + nsources - 1.
+ *
+ * @return the number of edges scanned by the BFS steps
+ */
+static unsigned long long spmm_bc_batch(matrix_pcsr_t *g,
+                          int first,
+                          int nsources,
+                          spmm_bc_workspace_t *ws,
+                          double *bc_scores) {
+
+    const int B = SPMM_BC_LANES;
+    matrix_block_t *F = &ws->frontier;
+    matrix_block_t *N = &ws->next;
+    matrix_block_t *sigma = &ws->sigma;
+    int *level = ws->level;
+    int *stack = ws->stack;
+    int *ends = ws->ends;
+    int tail = 0, depth = 0;
+    unsigned long long nedges = 0;
+
+    for (int j = 0; j < nsources; j++) {
+        int s = first + j;
+        F->values[(size_t) s * B + j] = 1.0;
+        sigma->values[(size_t) s * B + j] = 1.0;
+        level[(size_t) s * B + j] = 0;
+        list_block_row(F, s);
+        list_block_row(sigma, s);
+        stack[tail++] = s;
+    }
+    ends[0] = 0;
+    ends[1] = tail;
+
+    /*
+     * N<not visited> = A' * F, whose entries are the numbers of shortest
+     * paths to the vertices of the next level.
+     */
+    while (true) {
+        for (int k = 0; k < F->nnzrows; k++)
+            nedges += g->row_offsets[F->rows[k] + 1] -
+                      g->row_offsets[F->rows[k]];
+
+        spmm_t_masked(g, F, level, INT_MAX, plus_times_semiring, N);
+        if (N->nnzrows == 0)
+            break;
+
+        for (int k = 0; k < N->nnzrows; k++) {
+            int w = N->rows[k];
+            const double *n_w = N->values + (size_t) w * B;
+            for (int j = 0; j < B; j++) {
+                if (n_w[j] != 0.0) {
+                    level[(size_t) w * B + j] = depth + 1;
+                    sigma->values[(size_t) w * B + j] = n_w[j];
+                }
+            }
+            list_block_row(sigma, w);
+            stack[tail++] = w;
+        }
+
+        clear_matrix_block(F, plus_times_semiring);
+        matrix_block_t tmp = *F;
+        *F = *N;
+        *N = tmp;
+
+        depth++;
+        ends[depth + 1] = tail;
+    }
+    clear_matrix_block(F, plus_times_semiring);
+
+    /*
+     * The frontier blocks are reused as T, which holds (1 + delta) / sigma
+     * of the entries of the level below, and W = A * T masked by the
+     * entries of the current level.
+     */
+    matrix_block_t *T = F;
+    matrix_block_t *W = N;
+
+    for (int i = ends[depth]; i < ends[depth + 1]; i++) {
+        int w = stack[i];
+        for (int j = 0; j < B; j++) {
+            size_t idx = (size_t) w * B + j;
+            if (level[idx] == depth)
+                T->values[idx] = 1.0 / sigma->values[idx];
+        }
+        list_block_row(T, w);
+    }
+
+    for (int l = depth - 1; l > 0; l--) {
+
+        for (int i = ends[l]; i < ends[l + 1]; i++)
+            list_block_row(W, stack[i]);
+
+        spmm_masked(g, T, level, l, plus_times_semiring, W);
+        clear_matrix_block(T, plus_times_semiring);
+
+        for (int k = 0; k < W->nnzrows; k++) {
+            int v = W->rows[k];
+            double dep_sum = 0.0;
+            for (int j = 0; j < B; j++) {
+                size_t idx = (size_t) v * B + j;
+                if (level[idx] == l) {
+                    double dep = sigma->values[idx] * W->values[idx];
+                    dep_sum += dep;
+                    T->values[idx] = (1.0 + dep) / sigma->values[idx];
+                }
+            }
+            bc_scores[v] += dep_sum;
+            list_block_row(T, v);
+        }
+        clear_matrix_block(W, plus_times_semiring);
+    }
+    clear_matrix_block(T, plus_times_semiring);
+
+    /*
+     * Reset the levels of the vertices reached from the batch.
+     */
+    for (int k = 0; k < sigma->nnzrows; k++) {
+        int w = sigma->rows[k];
+        for (int j = 0; j < B; j++)
+            level[(size_t) w * B + j] = INT_MAX;
+    }
+    clear_matrix_block(sigma, plus_times_semiring);
+
+    return nedges;
+}
+
+int compute_spmm_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        bool directed,
+                        int nthreads,
+                        stats_t *stats) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    int nbatches = (nvertices + SPMM_BC_LANES - 1) / SPMM_BC_LANES;
+    double tstart = get_time();
+    int err = EXIT_SUCCESS;
+    unsigned long long nedges_traversed = 0;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *t_bc = (double *) calloc((size_t) nthreads * nvertices,
+                                   sizeof(double));
+    if (t_bc == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        double *bc = t_bc + (size_t) omp_get_thread_num() * nvertices;
+        spmm_bc_workspace_t ws;
+        int t_err = init_spmm_bc_workspace(&ws, nvertices);
+
+#pragma omp for schedule(dynamic, 1) reduction(+:nedges_traversed)
+        for (int b = 0; b < nbatches; b++) {
+
+            if (t_err)
+                continue;
+
+            int first = b * SPMM_BC_LANES;
+            nedges_traversed += spmm_bc_batch(
+                    g, first, min(SPMM_BC_LANES, nvertices - first), &ws, bc);
+        }
+
+        if (t_err) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        }
+        free_spmm_bc_workspace(&ws);
+    }
+
+    if (err == EXIT_SUCCESS) {
+        for (int v = 0; v < nvertices; v++) {
+            double sum = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                sum += t_bc[(size_t) t * nvertices + v];
+            bc_scores[v] = directed ? sum : sum / 2;
+        }
+    }
+    free(t_bc);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges_traversed;
+    }
+
+    return err;
+}
@@ -83,8 +83,10 @@ int append_stats(stats_t *stats, char *fname, int technique_id) {
 
     FILE *f = fopen(fname, "a");
 
-    if (stats->total_time == 0 || stats->load_time == 0 ||
-        stats->bc_comp_time == 0 || stats->unload_time == 0 ||
+    /*
+     * Load and unload times are zero for the techniques run on the CPU.
+     */
+    if (stats->total_time == 0 || stats->bc_comp_time == 0 ||
         stats->nedges_traversed == 0) {
         ZF_LOGE("Statistics not completely initialized");
         return EXIT_FAILURE;
@@ -116,6 +118,16 @@ int dump_scores(int nvertices,
                 const double *bc_scores,
                 const double *cl_scores,
                 char *fname) {
+    return dump_selected_scores(nvertices, 0, degree_scores, bc_scores,
+                                cl_scores, fname);
+}
+
+int dump_selected_scores(int nselected,
+                         const int *selected,
+                         const int *degree_scores,
+                         const double *bc_scores,
+                         const double *cl_scores,
+                         char *fname) {
 
     if (fname == 0) {
         ZF_LOGE("No filename given");
@@ -143,11 +155,61 @@ int dump_scores(int nvertices,
         fprintf(f, "\"Vertex Id\", \"Degree\", \"Betweenness\","
                    " \"Closeness\"\n");
 
-        for (int i = 0; i < nvertices; i++) {
-            fprintf(f, "%d, %d, %.2f, %.2f\n", i,
-                    degree_scores[i],
-                    bc_scores[i],
-                    cl_scores[i]);
+        for (int i = 0; i < nselected; i++) {
+            int v = (selected != 0) ? selected[i] : i;
+            fprintf(f, "%d, %d, %.2f, %.2f\n", v,
+                    degree_scores[v],
+                    bc_scores[v],
+                    cl_scores[v]);
+        }
+
+    } else {
+        ZF_LOGE("Failed to create output file");
+        return EXIT_FAILURE;
+    }
+
+    return close_stream(f);
+}
+
+int dump_directed_scores(int nvertices,
+                         const int *in_degree,
+                         const int *out_degree,
+                         const double *bc_scores,
+                         const double *cl_scores,
+                         char *fname) {
+
+    if (fname == 0) {
+        ZF_LOGE("No filename given");
+        return EXIT_FAILURE;
+    }
+
+    if (in_degree == 0 || out_degree == 0) {
+        ZF_LOGE("Degree centrality scores not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (bc_scores == 0) {
+        ZF_LOGE("Betweenness centrality scores not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (cl_scores == 0) {
+        ZF_LOGE("Closeness centrality scores not initialized");
+        return EXIT_FAILURE;
+    }
+
+    FILE *f = fopen(fname, "w");
+
+    if (f != 0) {
+        fprintf(f, "\"Vertex Id\", \"In-degree\", \"Out-degree\","
+                   " \"Betweenness\", \"Harmonic Closeness\"\n");
+
+        for (int v = 0; v < nvertices; v++) {
+            fprintf(f, "%d, %d, %d, %.2f, %.2f\n", v,
+                    in_degree[v],
+                    out_degree[v],
+                    bc_scores[v],
+                    cl_scores[v]);
         }
 
     } else {
@@ -0,0 +1,400 @@
+/****************************************************************************
+ * @file bc_vp_cpu.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Vertex-parallel Betweenness Centrality on the CPU with vectorized
+ * frontier compaction and initialization.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "bc_vp_cpu.h"
+#include "bc.h"
+
+/*
+ * The vectorized kernels are compiled for their instruction set whatever
+ * the flags of the translation unit, and are called only if the CPU
+ * supports it.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BC_VP_CPU_X86
+#include <immintrin.h>
+#endif
+
+typedef void (*reset_fn_t)(int *, unsigned long long *, double *, int);
+typedef int (*compact_fn_t)(const int *, int, int, int *);
+
+static void reset_scalar(int *d,
+                         unsigned long long *sigma,
+                         double *delta,
+                         int nvertices) {
+    for (int i = 0; i < nvertices; i++) {
+        d[i] = INT_MAX;
+        sigma[i] = 0;
+        delta[i] = 0.0;
+    }
+}
+
+/**
+ * @brief Compacts the vertices between begin and end, also used for the
+ * ones left over by the vectorized kernels.
+ */
+static int compact_range(const int *d, int begin, int end, int depth,
+                         int *frontier) {
+    int len = 0;
+    for (int i = begin; i < end; i++) {
+        if (d[i] == depth)
+            frontier[len++] = i;
+    }
+    return len;
+}
+
+static int compact_scalar(const int *d, int nvertices, int depth,
+                          int *frontier) {
+    return compact_range(d, 0, nvertices, depth, frontier);
+}
+
+#ifdef BC_VP_CPU_X86
+
+__attribute__((target("avx2"))) static void
+reset_avx2(int *d, unsigned long long *sigma, double *delta, int nvertices) {
+
+    const __m256i inf = _mm256_set1_epi32(INT_MAX);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256d zero_pd = _mm256_setzero_pd();
+
+    int i = 0;
+    for (; i + 8 <= nvertices; i += 8) {
+        _mm256_storeu_si256((__m256i *) (d + i), inf);
+        _mm256_storeu_si256((__m256i *) (sigma + i), zero);
+        _mm256_storeu_si256((__m256i *) (sigma + i + 4), zero);
+        _mm256_storeu_pd(delta + i, zero_pd);
+        _mm256_storeu_pd(delta + i + 4, zero_pd);
+    }
+    reset_scalar(d + i, sigma + i, delta + i, nvertices - i);
+}
+
+/**
+ * @brief Compares 32 distances at a time, so that the blocks without
+ * vertices of the frontier, the most of them, cost one test. The positions
+ * of the matches are read from the bits of the comparison masks.
+ */
+__attribute__((target("avx2"))) static int
+compact_avx2(const int *d, int nvertices, int depth, int *frontier) {
+
+    const __m256i key = _mm256_set1_epi32(depth);
+    int len = 0;
+
+    int i = 0;
+    for (; i + 32 <= nvertices; i += 32) {
+        __m256i c0 = _mm256_cmpeq_epi32(
+                _mm256_loadu_si256((const __m256i *) (d + i)), key);
+        __m256i c1 = _mm256_cmpeq_epi32(
+                _mm256_loadu_si256((const __m256i *) (d + i + 8)), key);
+        __m256i c2 = _mm256_cmpeq_epi32(
+                _mm256_loadu_si256((const __m256i *) (d + i + 16)), key);
+        __m256i c3 = _mm256_cmpeq_epi32(
+                _mm256_loadu_si256((const __m256i *) (d + i + 24)), key);
+
+        __m256i any = _mm256_or_si256(_mm256_or_si256(c0, c1),
+                                      _mm256_or_si256(c2, c3));
+        if (_mm256_testz_si256(any, any))
+            continue;
+
+        unsigned long long mask =
+                (unsigned long long) (unsigned)
+                        _mm256_movemask_ps(_mm256_castsi256_ps(c0)) |
+                ((unsigned long long) (unsigned)
+                         _mm256_movemask_ps(_mm256_castsi256_ps(c1))
+                 << 8) |
+                ((unsigned long long) (unsigned)
+                         _mm256_movemask_ps(_mm256_castsi256_ps(c2))
+                 << 16) |
+                ((unsigned long long) (unsigned)
+                         _mm256_movemask_ps(_mm256_castsi256_ps(c3))
+                 << 24);
+
+        while (mask != 0) {
+            frontier[len++] = i + __builtin_ctzll(mask);
+            mask &= mask - 1;
+        }
+    }
+
+    return len + compact_range(d, i, nvertices, depth, frontier + len);
+}
+
+__attribute__((target("avx512f"))) static void
+reset_avx512(int *d, unsigned long long *sigma, double *delta,
+             int nvertices) {
+
+    const __m512i inf = _mm512_set1_epi32(INT_MAX);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512d zero_pd = _mm512_setzero_pd();
+
+    int i = 0;
+    for (; i + 16 <= nvertices; i += 16) {
+        _mm512_storeu_si512((void *) (d + i), inf);
+        _mm512_storeu_si512((void *) (sigma + i), zero);
+        _mm512_storeu_si512((void *) (sigma + i + 8), zero);
+        _mm512_storeu_pd(delta + i, zero_pd);
+        _mm512_storeu_pd(delta + i + 8, zero_pd);
+    }
+    reset_scalar(d + i, sigma + i, delta + i, nvertices - i);
+}
+
+/**
+ * @brief Compares 16 distances at a time and writes the ids of the matches
+ * next to each other with a compress store.
+ */
+__attribute__((target("avx512f"))) static int
+compact_avx512(const int *d, int nvertices, int depth, int *frontier) {
+
+    const __m512i key = _mm512_set1_epi32(depth);
+    const __m512i step = _mm512_set1_epi32(16);
+    __m512i ids = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                    13, 14, 15);
+    int len = 0;
+
+    int i = 0;
+    for (; i + 16 <= nvertices; i += 16) {
+        __mmask16 mask = _mm512_cmpeq_epi32_mask(
+                _mm512_loadu_si512((const void *) (d + i)), key);
+        if (mask != 0) {
+            _mm512_mask_compressstoreu_epi32(frontier + len, mask, ids);
+            len += __builtin_popcount(mask);
+        }
+        ids = _mm512_add_epi32(ids, step);
+    }
+
+    return len + compact_range(d, i, nvertices, depth, frontier + len);
+}
+
+#endif
+
+SimdLevel get_simd_level() {
+#ifdef BC_VP_CPU_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return simd_avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return simd_avx2;
+#endif
+    return simd_scalar;
+}
+
+const char *get_simd_name(SimdLevel level) {
+
+    switch (level) {
+        case simd_scalar:
+            return "scalar";
+        case simd_avx2:
+            return "avx2";
+        case simd_avx512:
+            return "avx512";
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Get the kernels of the widest instruction set not wider than level
+ * and supported by the CPU.
+ */
+static SimdLevel get_kernels(SimdLevel level,
+                             reset_fn_t *reset,
+                             compact_fn_t *compact) {
+
+    SimdLevel supported = get_simd_level();
+    if (level > supported)
+        level = supported;
+
+    *reset = reset_scalar;
+    *compact = compact_scalar;
+
+#ifdef BC_VP_CPU_X86
+    if (level == simd_avx512) {
+        *reset = reset_avx512;
+        *compact = compact_avx512;
+    } else if (level == simd_avx2) {
+        *reset = reset_avx2;
+        *compact = compact_avx2;
+    }
+#else
+    level = simd_scalar;
+#endif
+
+    return level;
+}
+
+int compact_frontier(const int *d,
+                     int nvertices,
+                     int depth,
+                     int *frontier,
+                     SimdLevel level) {
+
+    reset_fn_t reset;
+    compact_fn_t compact;
+    get_kernels(level, &reset, &compact);
+
+    return compact(d, nvertices, depth, frontier);
+}
+
+int compute_vp_bc_cpu(matrix_pcsr_t *g,
+                      double *bc_scores,
+                      bool directed,
+                      SimdLevel level,
+                      int nthreads,
+                      stats_t *stats) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    double tstart = get_time();
+    unsigned long long nedges_traversed = 0;
+
+    reset_fn_t reset;
+    compact_fn_t compact;
+    level = get_kernels(level, &reset, &compact);
+
+    ZF_LOGI("Vertex-parallel kernels: %s", get_simd_name(level));
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    /*
+     * Scratch arrays and scores of all the threads, each thread uses a
+     * slice of nvertices elements, nvertices + 2 for the level ends as in
+     * compute_ls_bc_cpu.
+     */
+    size_t size = (size_t) nthreads * nvertices;
+    auto *sigma = (unsigned long long *) malloc(
+            size * sizeof(unsigned long long));
+    auto *d = (int *) malloc(size * sizeof(int));
+    auto *delta = (double *) malloc(size * sizeof(double));
+    auto *t_bc = (double *) calloc(size, sizeof(double));
+    auto *stack = (int *) malloc(size * sizeof(int));
+    auto *ends = (int *) malloc((size + 2 * nthreads) * sizeof(int));
+
+    if (sigma == 0 || d == 0 || delta == 0 || t_bc == 0 || stack == 0 ||
+        ends == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(sigma);
+        free(d);
+        free(delta);
+        free(t_bc);
+        free(stack);
+        free(ends);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nedges_traversed)
+    {
+        size_t offset = (size_t) omp_get_thread_num() * nvertices;
+        unsigned long long *t_sigma = sigma + offset;
+        int *t_d = d + offset;
+        double *t_delta = delta + offset;
+        double *bc = t_bc + offset;
+        int *t_stack = stack + offset;
+        int *t_ends = ends + offset + 2 * omp_get_thread_num();
+
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < nvertices; s++) {
+
+            reset(t_d, t_sigma, t_delta, nvertices);
+
+            int depth = 0;
+
+            t_sigma[s] = 1;
+            t_d[s] = 0;
+            t_stack[0] = s;
+            t_ends[0] = 0;
+            t_ends[1] = 1;
+
+            /*
+             * The vertices discovered from a level are found by the scan
+             * that follows it, which appends them to the stack.
+             */
+            while (t_ends[depth + 1] > t_ends[depth]) {
+
+                for (int i = t_ends[depth]; i < t_ends[depth + 1]; i++) {
+
+                    int v = t_stack[i];
+
+                    for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1];
+                         k++) {
+
+                        int w = g->cols[k];
+
+                        if (t_d[w] == INT_MAX)
+                            t_d[w] = depth + 1;
+
+                        if (t_d[w] == depth + 1)
+                            t_sigma[w] += t_sigma[v];
+                    }
+                    nedges_traversed +=
+                            g->row_offsets[v + 1] - g->row_offsets[v];
+                }
+
+                depth++;
+                t_ends[depth + 1] =
+                        t_ends[depth] + compact(t_d, nvertices, depth,
+                                                t_stack + t_ends[depth]);
+            }
+
+            accumulate_ls_dependencies(g, t_stack, t_ends, depth, t_d,
+                                       t_sigma, t_delta, bc);
+        }
+
+#pragma omp for schedule(static)
+        for (int v = 0; v < nvertices; v++) {
+            double sum = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                sum += t_bc[(size_t) t * nvertices + v];
+            bc_scores[v] = directed ? sum : sum / 2;
+        }
+    }
+
+    free(sigma);
+    free(d);
+    free(delta);
+    free(t_bc);
+    free(stack);
+    free(ends);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nedges_traversed;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,342 @@
+/****************************************************************************
+ * @file bc_weighted.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Functions to compute the Betweenness and the Closeness Centrality of
+ * graphs with positive integer weights on the CPU.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include "bc_weighted.h"
+
+#define DIST_INF ULLONG_MAX
+
+void radix_heap_clear(radix_heap_t *h) {
+    h->last = 0;
+    h->size = 0;
+    for (int i = 0; i < RADIX_NBUCKETS; i++)
+        h->buckets[i].clear();
+}
+
+static inline int radix_bucket(unsigned long long last,
+                               unsigned long long key) {
+    return (key == last) ? 0 : 64 - __builtin_clzll(key ^ last);
+}
+
+void radix_heap_push(radix_heap_t *h, unsigned long long key, int vertex) {
+    h->buckets[radix_bucket(h->last, key)].push_back({key, vertex});
+    h->size++;
+}
+
+radix_item_t radix_heap_pop(radix_heap_t *h) {
+
+    if (h->buckets[0].empty()) {
+        int i = 1;
+        while (h->buckets[i].empty())
+            i++;
+
+        /*
+         * The minimum of the first non-empty bucket becomes the last key,
+         * the other keys of the bucket now differ from it in lower bits.
+         */
+        std::vector<radix_item_t> &b = h->buckets[i];
+        unsigned long long min_key = b[0].key;
+        for (size_t j = 1; j < b.size(); j++)
+            min_key = (b[j].key < min_key) ? b[j].key : min_key;
+
+        h->last = min_key;
+        for (size_t j = 0; j < b.size(); j++)
+            h->buckets[radix_bucket(min_key, b[j].key)].push_back(b[j]);
+        b.clear();
+    }
+
+    radix_item_t item = h->buckets[0].back();
+    h->buckets[0].pop_back();
+    h->size--;
+
+    return item;
+}
+
+/**
+ * @brief Whether every weight of the graph is positive.
+ */
+static bool has_positive_weights(matrix_rcsr_t *g) {
+    for (int k = 0; k < g->row_offsets[g->nrows]; k++) {
+        if (g->weights[k] <= 0)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Dijkstra visit from s that counts the shortest paths too. An
+ * improved distance is pushed again in the heap instead of being decreased,
+ * the stale items are skipped when they are extracted.
+ *
+ * @return the number of vertices settled, stored in order by increasing
+ * distance from s
+ */
+static int dijkstra_visit(matrix_rcsr_t *g,
+                          int s,
+                          unsigned long long *dist,
+                          double *sigma,
+                          int *order,
+                          radix_heap_t *heap,
+                          unsigned long long *nrelaxed) {
+
+    int nsettled = 0;
+
+    radix_heap_clear(heap);
+    dist[s] = 0;
+    sigma[s] = 1.0;
+    radix_heap_push(heap, 0, s);
+
+    while (heap->size > 0) {
+        radix_item_t item = radix_heap_pop(heap);
+        int v = item.vertex;
+
+        if (item.key != dist[v])
+            continue;
+
+        order[nsettled++] = v;
+
+        for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++) {
+            int w = g->cols[k];
+            unsigned long long alt = dist[v] + g->weights[k];
+
+            if (alt < dist[w]) {
+                dist[w] = alt;
+                sigma[w] = sigma[v];
+                radix_heap_push(heap, alt, w);
+            } else if (alt == dist[w]) {
+                sigma[w] += sigma[v];
+            }
+        }
+        *nrelaxed += g->row_offsets[v + 1] - g->row_offsets[v];
+    }
+
+    return nsettled;
+}
+
+int compute_dijkstra_bc_cpu(matrix_rcsr_t *g,
+                            double *bc_scores,
+                            bool directed,
+                            int nthreads,
+                            stats_t *stats) {
+
+    if (!check_matrix_rcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (!has_positive_weights(g)) {
+        ZF_LOGF("Weights must be positive");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    double tstart = get_time();
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    size_t size = (size_t) nthreads * nvertices;
+    auto *dist = (unsigned long long *) malloc(
+            size * sizeof(unsigned long long));
+    auto *sigma = (double *) malloc(size * sizeof(double));
+    auto *delta = (double *) malloc(size * sizeof(double));
+    auto *order = (int *) malloc(size * sizeof(int));
+    auto *partial = (double *) calloc(size, sizeof(double));
+
+    if (dist == 0 || sigma == 0 || delta == 0 || order == 0 ||
+        partial == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(dist);
+        free(sigma);
+        free(delta);
+        free(order);
+        free(partial);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long long nrelaxed = 0;
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nrelaxed)
+    {
+        size_t offset = (size_t) omp_get_thread_num() * nvertices;
+        unsigned long long *t_dist = dist + offset;
+        double *t_sigma = sigma + offset;
+        double *t_delta = delta + offset;
+        int *t_order = order + offset;
+        double *t_bc = partial + offset;
+        radix_heap_t heap;
+
+        for (int i = 0; i < nvertices; i++) {
+            t_dist[i] = DIST_INF;
+            t_sigma[i] = 0.0;
+            t_delta[i] = 0.0;
+        }
+
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < nvertices; s++) {
+
+            int nsettled = dijkstra_visit(g, s, t_dist, t_sigma, t_order,
+                                          &heap, &nrelaxed);
+
+            /*
+             * Vertices are settled after all their predecessors, so walking
+             * the order backwards each vertex pulls the dependencies of its
+             * successors, which works for directed graphs too.
+             */
+            for (int i = nsettled - 1; i > 0; i--) {
+                int v = t_order[i];
+                double dep = 0.0;
+
+                for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1];
+                     k++) {
+                    int w = g->cols[k];
+                    if (t_dist[w] != DIST_INF &&
+                        t_dist[w] == t_dist[v] + g->weights[k])
+                        dep += (1.0 + t_delta[w]) / t_sigma[w];
+                }
+
+                t_delta[v] = t_sigma[v] * dep;
+                t_bc[v] += t_delta[v];
+            }
+
+            for (int i = 0; i < nsettled; i++) {
+                int w = t_order[i];
+                t_dist[w] = DIST_INF;
+                t_sigma[w] = 0.0;
+                t_delta[w] = 0.0;
+            }
+        }
+
+        /*
+         * Undirected pairs are counted from both endpoints.
+         */
+#pragma omp for schedule(static)
+        for (int v = 0; v < nvertices; v++) {
+            double score = 0.0;
+            for (int t = 0; t < nthreads; t++)
+                score += partial[(size_t) t * nvertices + v];
+            bc_scores[v] = directed ? score : score / 2;
+        }
+    }
+
+    ZF_LOGI("Weighted betweenness computed by relaxing %llu edges",
+            nrelaxed);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = nrelaxed;
+    }
+
+    free(dist);
+    free(sigma);
+    free(delta);
+    free(order);
+    free(partial);
+
+    return EXIT_SUCCESS;
+}
+
+int compute_dijkstra_cl_cpu(matrix_rcsr_t *g, double *cl_scores,
+                            int nthreads) {
+
+    if (!check_matrix_rcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (!has_positive_weights(g)) {
+        ZF_LOGF("Weights must be positive");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    size_t size = (size_t) nthreads * nvertices;
+    auto *dist = (unsigned long long *) malloc(
+            size * sizeof(unsigned long long));
+    auto *sigma = (double *) malloc(size * sizeof(double));
+    auto *order = (int *) malloc(size * sizeof(int));
+
+    if (dist == 0 || sigma == 0 || order == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(dist);
+        free(sigma);
+        free(order);
+        return EXIT_FAILURE;
+    }
+
+    unsigned long long nrelaxed = 0;
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nrelaxed)
+    {
+        size_t offset = (size_t) omp_get_thread_num() * nvertices;
+        unsigned long long *t_dist = dist + offset;
+        double *t_sigma = sigma + offset;
+        int *t_order = order + offset;
+        radix_heap_t heap;
+
+        for (int i = 0; i < nvertices; i++)
+            t_dist[i] = DIST_INF;
+
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < nvertices; s++) {
+
+            int nsettled = dijkstra_visit(g, s, t_dist, t_sigma, t_order,
+                                          &heap, &nrelaxed);
+
+            unsigned long long tot_d =
+                    (unsigned long long) (nvertices - nsettled) * INT_MAX;
+            for (int i = 0; i < nsettled; i++) {
+                tot_d += t_dist[t_order[i]];
+                t_dist[t_order[i]] = DIST_INF;
+            }
+
+            cl_scores[s] = ((double) nvertices - 1.0) / (double) tot_d;
+        }
+    }
+
+    ZF_LOGI("Weighted closeness computed by relaxing %llu edges", nrelaxed);
+
+    free(dist);
+    free(sigma);
+    free(order);
+
+    return EXIT_SUCCESS;
+}
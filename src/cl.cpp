@@ -2,7 +2,8 @@
  * @file cl.cpp
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Function to compute the Closeness Centrality on the CPU serially.
+ * @brief Functions to compute the Closeness Centrality on the CPU, of every
+ * vertex or of the top-k ones only.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -35,25 +36,348 @@
 
 #include "cl.h"
 
+#include <algorithm>
+
 void compute_cl_cpu(matrix_pcsr_t *g, double *cl_cpu) {
 
     int nvertices = g->nrows;
+    bfs_workspace_t ws;
 
     auto d = (int*) malloc(g->nrows * sizeof(int));
 
+    if (d == 0 || init_bfs_workspace(&ws, nvertices)) {
+        ZF_LOGF("Could not allocate memory");
+        free(d);
+        return;
+    }
+
     fill(d, g->nrows, INT_MAX);
 
     for(int i = 0; i < nvertices; i++) {
-        BFS_visit(g, d, i);
+        BFS_visit_dir_opt(g, d, i, &ws);
 
-        unsigned long long tot_d = 0;
-        for(int j = 0; j < nvertices; j++)
-            tot_d += d[j];
+        /*
+         * Unreachable vertices keep an infinite distance as in BFS_visit.
+         */
+        unsigned long long tot_d =
+                (unsigned long long) (nvertices - ws.nvisited) * INT_MAX;
+        for(int j = 0; j < ws.nvisited; j++)
+            tot_d += d[ws.order[j]];
 
         double res = ((double) nvertices - 1.0) / (double) tot_d;
         cl_cpu[i] = res;
-        fill(d, g->nrows, INT_MAX);
+
+        /*
+         * Reset only the distances of the visited vertices.
+         */
+        for(int j = 0; j < ws.nvisited; j++)
+            d[ws.order[j]] = INT_MAX;
+    }
+
+    ZF_LOGI("Closeness computed by inspecting %llu edges",
+            ws.nedges_inspected);
+
+    free_bfs_workspace(&ws);
+    free(d);
+}
+
+/**
+ * @brief Visits the graph from each vertex and computes either its harmonic
+ * closeness or its Wasserman-Faust closeness.
+ */
+static void compute_reached_cl_cpu(matrix_pcsr_t *g,
+                                   double *cl_cpu,
+                                   bool wasserman_faust) {
+
+    int nvertices = g->nrows;
+    unsigned long long ninspected = 0;
+
+    auto d = (int *) malloc(nvertices * sizeof(int));
+    auto order = (int *) malloc(nvertices * sizeof(int));
+
+    if (d == 0 || order == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(d);
+        free(order);
+        return;
+    }
+
+    fill(d, nvertices, INT_MAX);
+
+    for (int s = 0; s < nvertices; s++) {
+
+        /*
+         * Top-down visit only, since bottom-up steps would need the
+         * in-edges of a directed graph.
+         */
+        int head = 0, tail = 0;
+        double inv_sum = 0.0;
+        unsigned long long sum = 0;
+
+        d[s] = 0;
+        order[tail++] = s;
+
+        while (head < tail) {
+            int v = order[head++];
+
+            for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++) {
+                int w = g->cols[k];
+                if (d[w] == INT_MAX) {
+                    d[w] = d[v] + 1;
+                    inv_sum += 1.0 / d[w];
+                    sum += d[w];
+                    order[tail++] = w;
+                }
+            }
+            ninspected += g->row_offsets[v + 1] - g->row_offsets[v];
+        }
+
+        /*
+         * Unreachable vertices add nothing.
+         */
+        if (nvertices < 2 || tail < 2)
+            cl_cpu[s] = 0.0;
+        else if (wasserman_faust)
+            cl_cpu[s] = (tail - 1.0) * (tail - 1.0) /
+                        ((nvertices - 1.0) * (double) sum);
+        else
+            cl_cpu[s] = inv_sum / (nvertices - 1.0);
+
+        for (int j = 0; j < tail; j++)
+            d[order[j]] = INT_MAX;
     }
 
+    ZF_LOGI("%s closeness computed by inspecting %llu edges",
+            wasserman_faust ? "Wasserman-Faust" : "Harmonic", ninspected);
+
     free(d);
+    free(order);
+}
+
+void compute_harmonic_cl_cpu(matrix_pcsr_t *g, double *cl_cpu) {
+    compute_reached_cl_cpu(g, cl_cpu, false);
+}
+
+void compute_wf_cl_cpu(matrix_pcsr_t *g, double *cl_cpu) {
+    compute_reached_cl_cpu(g, cl_cpu, true);
+}
+
+/**
+ * @brief Whether the farness f of u is better than the farness h of v, with
+ * ties broken by the lowest id.
+ */
+static inline bool is_closer(unsigned long long f, int u,
+                             unsigned long long h, int v) {
+    return f < h || (f == h && u < v);
+}
+
+/**
+ * @brief Visits the graph from s level by level and stops as soon as the
+ * lower bound of the farness of s exceeds cutoff.
+ *
+ * @return the farness of s, ULLONG_MAX if the visit was cut
+ */
+static unsigned long long farness_cut(matrix_pcsr_t *g,
+                                      int s,
+                                      unsigned long long cutoff,
+                                      int *d,
+                                      int *queue,
+                                      unsigned long long *nedges) {
+
+    int nvertices = g->nrows;
+    int head = 0, tail = 0;
+    unsigned long long sum = 0;
+    bool cut = false;
+
+    d[s] = 0;
+    queue[tail++] = s;
+
+    for (int depth = 0; head < tail && !cut; depth++) {
+
+        int level_end = tail;
+        unsigned long long gamma = 0;
+
+        for (; head < level_end; head++) {
+            int v = queue[head];
+            int degree = g->row_offsets[v + 1] - g->row_offsets[v];
+
+            for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++) {
+                int w = g->cols[k];
+                if (d[w] == INT_MAX) {
+                    d[w] = depth + 1;
+                    sum += depth + 1;
+                    queue[tail++] = w;
+                }
+            }
+            *nedges += degree;
+        }
+
+        /*
+         * Each vertex of the new level has one edge going back, the others
+         * reach at most gamma vertices at distance depth + 2 and the rest
+         * is further away.
+         */
+        for (int i = level_end; i < tail; i++) {
+            int w = queue[i];
+            gamma += g->row_offsets[w + 1] - g->row_offsets[w] - 1;
+        }
+
+        unsigned long long left = nvertices - tail;
+        unsigned long long next = std::min(gamma, left);
+        unsigned long long bound = sum + next * (depth + 2) +
+                                   (left - next) * (depth + 3);
+
+        if (head < tail && bound > cutoff)
+            cut = true;
+    }
+
+    for (int i = 0; i < tail; i++)
+        d[queue[i]] = INT_MAX;
+
+    if (cut)
+        return ULLONG_MAX;
+
+    /*
+     * Unreachable vertices keep an infinite distance as in compute_cl_cpu.
+     */
+    return sum + (unsigned long long) (nvertices - tail) * INT_MAX;
+}
+
+int compute_topk_cl_cpu(matrix_pcsr_t *g,
+                        int k,
+                        int *topk,
+                        double *cl,
+                        int nthreads,
+                        unsigned long long *nedges_visited) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (k <= 0) {
+        ZF_LOGF("Invalid number of top vertices: %d", k);
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    k = min(k, nvertices);
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *order = (int *) malloc(nvertices * sizeof(int));
+    auto *farness = (unsigned long long *) malloc(
+            k * sizeof(unsigned long long));
+
+    if (order == 0 || farness == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(order);
+        free(farness);
+        return EXIT_FAILURE;
+    }
+
+    for (int v = 0; v < nvertices; v++)
+        order[v] = v;
+
+    std::sort(order, order + nvertices, [g](int a, int b) {
+        int deg_a = g->row_offsets[a + 1] - g->row_offsets[a];
+        int deg_b = g->row_offsets[b + 1] - g->row_offsets[b];
+        return deg_a > deg_b || (deg_a == deg_b && a < b);
+    });
+
+    /*
+     * The k best sources found so far, with the worst one at index worst.
+     */
+    int nfound = 0, worst = 0;
+    unsigned long long kth = ULLONG_MAX;
+    unsigned long long nedges = 0;
+    int err = EXIT_SUCCESS;
+
+#pragma omp parallel num_threads(nthreads) reduction(+ : nedges)
+    {
+        auto *d = (int *) malloc(nvertices * sizeof(int));
+        auto *queue = (int *) malloc(nvertices * sizeof(int));
+
+        if (d == 0 || queue == 0) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        } else {
+            fill(d, nvertices, INT_MAX);
+        }
+
+#pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < nvertices; i++) {
+
+            if (d == 0 || queue == 0)
+                continue;
+
+            int s = order[i];
+            unsigned long long cutoff;
+
+#pragma omp atomic read
+            cutoff = kth;
+
+            unsigned long long f = farness_cut(g, s, cutoff, d, queue,
+                                               &nedges);
+            if (f == ULLONG_MAX)
+                continue;
+
+#pragma omp critical(topk_cl)
+            {
+                if (nfound < k) {
+                    topk[nfound] = s;
+                    farness[nfound++] = f;
+                } else if (is_closer(f, s, farness[worst], topk[worst])) {
+                    topk[worst] = s;
+                    farness[worst] = f;
+                }
+
+                if (nfound == k) {
+                    worst = 0;
+                    for (int j = 1; j < k; j++) {
+                        if (is_closer(farness[worst], topk[worst],
+                                      farness[j], topk[j]))
+                            worst = j;
+                    }
+#pragma omp atomic write
+                    kth = farness[worst];
+                }
+            }
+        }
+
+        free(d);
+        free(queue);
+    }
+
+    if (err == EXIT_SUCCESS) {
+        /*
+         * Sort the top-k vertices by increasing farness.
+         */
+        for (int i = 1; i < k; i++) {
+            int v = topk[i];
+            unsigned long long f = farness[i];
+            int j = i - 1;
+            for (; j >= 0 && is_closer(f, v, farness[j], topk[j]); j--) {
+                topk[j + 1] = topk[j];
+                farness[j + 1] = farness[j];
+            }
+            topk[j + 1] = v;
+            farness[j + 1] = f;
+        }
+
+        for (int i = 0; i < k; i++)
+            cl[i] = ((double) nvertices - 1.0) / (double) farness[i];
+
+        ZF_LOGI("Top-%d closeness found by inspecting %llu edges", k,
+                nedges);
+    }
+
+    if (nedges_visited != 0)
+        *nedges_visited = nedges;
+
+    free(order);
+    free(farness);
+
+    return err;
 }
@@ -44,13 +44,16 @@ static void print_usage(char *app_name) {
     printf("Usage:\n %s\t[-i|--input file] [-t|--technique] [-b|--dump-scores file] \n"
            "\t\t[-s|--dump-stats file] [-v|--verbose] [-c|--check]\n"
            "\t\t[-wsl|--wself-loops] [-d|--device] [-q|--quiet]\n"
+           "\t\t[-n|--nthreads] [-k|--samples] [-p|--pivots]\n"
+           "\t\t[-e|--epsilon] [-a|--delta] [-o|--top] [-x|--no-cache]\n"
+           "\t\t[-r|--reorder] [-g|--scc] [-m|--closeness]\n"
            "\t\t[-u|--usage] ][-h|--help]\n",
            app_name);
 }
 
 static void print_help() {
 
-    const int nopt = 11;
+    const int nopt = 21;
     static struct commands_t cmds[nopt] = {
             {"(i) input \t= <filename>\t",
                     "input matrix market file"},
@@ -70,6 +73,27 @@ static void print_help() {
                     "technique used to distribute work among GPU threads"},
             {"(d) device\t\t\t",
                     "set the device id of the GPU, 0 is the default"},
+            {"(n) nthreads\t\t\t",
+                    "number of threads used by the CPU algorithms"},
+            {"(k) samples\t\t\t",
+                    "number of pivots of the approximate technique"},
+            {"(p) pivots\t\t\t",
+                    "distribution of the pivots, uniform or degree"},
+            {"(e) epsilon\t\t\t",
+                    "maximum error of the approximate technique"},
+            {"(a) delta\t\t\t",
+                    "probability of exceeding the maximum error"},
+            {"(o) top\t\t\t\t",
+                    "number of vertices found by the top-k technique"},
+            {"(x) no-cache\t\t\t",
+                    "don't read or write the binary cache of the graph"},
+            {"(r) reorder\t\t\t",
+                    "relabel vertices: none, rcm, degree or locality"},
+            {"(g) scc\t\t\t\t",
+                    "keep the largest strongly connected component of "
+                    "directed graphs"},
+            {"(m) closeness\t\t\t",
+                    "closeness variant: classic, harmonic or wf"},
             {"(u) usage\t\t\t",
                     "print usage of the command"},
             {"(h) help\t\t\t",
@@ -87,6 +111,16 @@ static void print_help() {
     printf("(1) Vertex Parallel\n");
     printf("(2) Edge Parallel\n");
     printf("(3) Work efficient\n");
+    printf("(4) Approximate (CPU sampling)\n");
+    printf("(5) Exact with degree-one folding (CPU)\n");
+    printf("(6) Exact with biconnected components (CPU)\n");
+    printf("(7) Exact with twin compression (CPU)\n");
+    printf("(8) Top-k (CPU sampling)\n");
+    printf("(9) Level synchronous (CPU)\n");
+    printf("(10) Vertex Parallel with AVX2/AVX-512 scans (CPU)\n");
+    printf("(11) Batched sources (CPU)\n");
+    printf("(12) Algebraic, sparse matrix products (CPU)\n");
+    printf("(13) Source parallel Brandes (CPU)\n");
 }
 
 /**
@@ -126,6 +160,26 @@ static long strtol_wcheck(const char *p, char *endp, int base) {
     return i;
 }
 
+/**
+ * @brief Parse char array to double with error handling.
+ *
+ * @param p pointer to the null-terminated byte string to be interpreted
+ * @return the parsed number or -1 if unsuccessful
+ */
+static double strtod_wcheck(const char *p) {
+    char *endp;
+
+    errno = 0;
+    double d = strtod(p, &endp);
+
+    if (errno == ERANGE || endp == p) {
+        ZF_LOGE("Conversion error occurred");
+        return -1;
+    }
+
+    return d;
+}
+
 /**
  * @brief Concatenate two strings. Uses heap memory.
  *
@@ -154,6 +208,26 @@ static const char* get_technique_from_id(ParStrategy technique) {
             return "Vertex Parallel";
         case edge_parallel:
             return "Edge Parallel";
+        case approximate:
+            return "Approximate";
+        case folded:
+            return "Degree-one Folding";
+        case biconnected:
+            return "Biconnected Components";
+        case twins:
+            return "Twin Compression";
+        case top_k:
+            return "Top-k";
+        case level_sync:
+            return "Level Synchronous";
+        case vertex_parallel_cpu:
+            return "Vertex Parallel (CPU)";
+        case batched:
+            return "Batched";
+        case algebraic:
+            return "Algebraic (CPU)";
+        case source_parallel_cpu:
+            return "Source Parallel (CPU)";
         default:
             ZF_LOGE("Invalid technique");
             return 0;
@@ -168,12 +242,22 @@ int parse_args(params_t *params, int argc, char *argv[]) {
     int self_loops_allowed = 0;
     int show_usage = 0;
     int quiet = 0;
+    int no_cache = 0;
+    int use_scc = 0;
 
     char *technique = 0;
     char *dump_scores = 0;
     char *dump_stats = 0;
     char *input_file = 0;
     char *device_id = 0;
+    char *nthreads = 0;
+    char *nsamples = 0;
+    char *pivots = 0;
+    char *epsilon = 0;
+    char *delta = 0;
+    char *topk = 0;
+    char *reorder = 0;
+    char *closeness = 0;
     int index;
     int cmd;
 
@@ -184,8 +268,18 @@ int parse_args(params_t *params, int argc, char *argv[]) {
                     {"check",       no_argument,       0, 'c'},
                     {"help",        no_argument,       0, 'h'},
                     {"wself-loops", no_argument,       0, 'l'},
+                    {"no-cache",    no_argument,       0, 'x'},
+                    {"reorder",     required_argument, 0, 'r'},
+                    {"scc",         no_argument,       0, 'g'},
+                    {"closeness",   required_argument, 0, 'm'},
                     {"usage",       no_argument,       0, 'u'},
                     {"device",      no_argument,       0, 'd'},
+                    {"nthreads",    required_argument, 0, 'n'},
+                    {"samples",     required_argument, 0, 'k'},
+                    {"pivots",      required_argument, 0, 'p'},
+                    {"epsilon",     required_argument, 0, 'e'},
+                    {"delta",       required_argument, 0, 'a'},
+                    {"top",         required_argument, 0, 'o'},
                     {"dump-scores", required_argument, 0, 'b'},
                     {"dump-stats",  required_argument, 0, 's'},
                     {"technique",   required_argument, 0, 't'},
@@ -196,7 +290,7 @@ int parse_args(params_t *params, int argc, char *argv[]) {
     while (true) {
 
         int option_index = 0;
-        cmd = getopt_long(argc, argv, "t:b:s:i:d:uvchql", long_options,
+        cmd = getopt_long(argc, argv, "t:b:s:i:d:n:k:p:e:a:o:r:m:uvchqlxg", long_options,
                           &option_index);
 
         /*
@@ -218,6 +312,12 @@ int parse_args(params_t *params, int argc, char *argv[]) {
             case 'l':
                 self_loops_allowed = 1;
                 break;
+            case 'x':
+                no_cache = 1;
+                break;
+            case 'g':
+                use_scc = 1;
+                break;
             case 'v':
                 verbose = 1;
                 break;
@@ -239,6 +339,30 @@ int parse_args(params_t *params, int argc, char *argv[]) {
             case 'd':
                 device_id = optarg;
                 break;
+            case 'n':
+                nthreads = optarg;
+                break;
+            case 'k':
+                nsamples = optarg;
+                break;
+            case 'p':
+                pivots = optarg;
+                break;
+            case 'r':
+                reorder = optarg;
+                break;
+            case 'm':
+                closeness = optarg;
+                break;
+            case 'e':
+                epsilon = optarg;
+                break;
+            case 'a':
+                delta = optarg;
+                break;
+            case 'o':
+                topk = optarg;
+                break;
             case '?':
                 // getopt_long already printed an error message.
                 break;
@@ -286,6 +410,18 @@ int parse_args(params_t *params, int argc, char *argv[]) {
      */
     params->self_loops_allowed = self_loops_allowed;
 
+    /*
+     * Whether the graph may be loaded from and stored to a binary cache
+     * next to the input file.
+     */
+    params->use_cache = !no_cache;
+
+    /*
+     * Whether directed graphs are reduced to their largest strongly
+     * connected component instead of the weakly connected one.
+     */
+    params->use_scc = use_scc;
+
     /*
      * Set the id of the device to be used. The default is 0.
      */
@@ -301,6 +437,112 @@ int parse_args(params_t *params, int argc, char *argv[]) {
         params->device_id = 0; // default is 0
     }
 
+    /*
+     * Set the number of threads used by the CPU algorithms. The default is
+     * 0, which lets OpenMP choose.
+     */
+    if (nthreads != 0) {
+        int tmp_nthreads = (int) (strtol_wcheck(nthreads, 0, 10));
+        if (tmp_nthreads <= 0) {
+            ZF_LOGF("Invalid number of threads");
+            return EXIT_FAILURE;
+        }
+        params->nthreads = tmp_nthreads;
+    } else {
+        params->nthreads = 0;
+    }
+
+    /*
+     * Sampling parameters of the approximate technique. Pivots are sampled
+     * only if their number is given, otherwise shortest paths are sampled
+     * until the error is at most epsilon with probability 1 - delta.
+     */
+    params->approx.nsamples = 0;
+    params->approx.pivots = uniform_pivots;
+    params->approx.epsilon = 0.01;
+    params->approx.delta = 0.1;
+    params->approx.seed = 1;
+
+    if (nsamples != 0) {
+        int tmp_nsamples = (int) (strtol_wcheck(nsamples, 0, 10));
+        if (tmp_nsamples <= 0) {
+            ZF_LOGF("Invalid number of samples");
+            return EXIT_FAILURE;
+        }
+        params->approx.nsamples = tmp_nsamples;
+    }
+
+    if (pivots != 0) {
+        if (strcmp(pivots, "uniform") == 0) {
+            params->approx.pivots = uniform_pivots;
+        } else if (strcmp(pivots, "degree") == 0) {
+            params->approx.pivots = degree_pivots;
+        } else {
+            ZF_LOGF("Invalid pivots distribution: uniform or degree");
+            return EXIT_FAILURE;
+        }
+    }
+
+    params->reorder = no_reorder;
+    if (reorder != 0) {
+        int id = no_reorder;
+        while (get_reorder_name((ReorderStrategy) id) != 0 &&
+               strcmp(reorder, get_reorder_name((ReorderStrategy) id)) != 0)
+            id++;
+
+        if (get_reorder_name((ReorderStrategy) id) == 0) {
+            ZF_LOGF("Invalid reordering: none, rcm, degree or locality");
+            return EXIT_FAILURE;
+        }
+        params->reorder = (ReorderStrategy) id;
+    }
+
+    params->closeness = classic_closeness;
+    if (closeness != 0) {
+        int id = classic_closeness;
+        while (get_closeness_name((ClosenessKind) id) != 0 &&
+               strcmp(closeness, get_closeness_name((ClosenessKind) id)) != 0)
+            id++;
+
+        if (get_closeness_name((ClosenessKind) id) == 0) {
+            ZF_LOGF("Invalid closeness: classic, harmonic or wf");
+            return EXIT_FAILURE;
+        }
+        params->closeness = (ClosenessKind) id;
+    }
+
+    if (epsilon != 0) {
+        double tmp_epsilon = strtod_wcheck(epsilon);
+        if (tmp_epsilon <= 0 || tmp_epsilon >= 1) {
+            ZF_LOGF("Invalid epsilon: must be in (0, 1)");
+            return EXIT_FAILURE;
+        }
+        params->approx.epsilon = tmp_epsilon;
+    }
+
+    if (delta != 0) {
+        double tmp_delta = strtod_wcheck(delta);
+        if (tmp_delta <= 0 || tmp_delta >= 1) {
+            ZF_LOGF("Invalid delta: must be in (0, 1)");
+            return EXIT_FAILURE;
+        }
+        params->approx.delta = tmp_delta;
+    }
+
+    /*
+     * Number of vertices found by the top-k technique, which are the only
+     * ones printed or dumped.
+     */
+    params->topk = 100;
+    if (topk != 0) {
+        int tmp_topk = (int) (strtol_wcheck(topk, 0, 10));
+        if (tmp_topk <= 0) {
+            ZF_LOGF("Invalid number of top vertices");
+            return EXIT_FAILURE;
+        }
+        params->topk = tmp_topk;
+    }
+
     /*
      * Whether to dump bc scores to a file.
      */
@@ -357,9 +599,35 @@ void print_run_config(params_t *p) {
     printf("\tBC scores file: \t%s\n", p->dump_scores);
     printf("\tTechnique: \t\t%s\n", technique);
     printf("\tDevice id: \t\t%d\n", p->device_id);
+    printf("\tCPU threads: \t\t%d\n", p->nthreads);
+    printf("\tReordering: \t\t%s\n", get_reorder_name(p->reorder));
+    printf("\tCloseness: \t\t%s\n", get_closeness_name(p->closeness));
+
+    if (p->technique == vertex_parallel_cpu)
+        printf("\tSIMD kernels: \t\t%s\n", get_simd_name(get_simd_level()));
+
+    if (p->technique == top_k) {
+        printf("\tTop vertices: \t\t%d\n", p->topk);
+        printf("\tEpsilon, delta: \t%g, %g\n", p->approx.epsilon,
+               p->approx.delta);
+    }
+
+    if (p->technique == approximate) {
+        if (p->approx.nsamples > 0) {
+            printf("\tPivots: \t\t%d, %s\n", p->approx.nsamples,
+                   (p->approx.pivots == degree_pivots) ? "degree" : "uniform");
+        } else {
+            printf("\tEpsilon, delta: \t%g, %g\n", p->approx.epsilon,
+                   p->approx.delta);
+        }
+    }
     printf("\tOutput: \t\t%s\n", output);
     printf("\tWith verification: \t%s\n",
            (p->run_check) ? "enabled" : "disabled");
+    printf("\tGraph cache: \t\t%s\n",
+           (p->use_cache) ? "enabled" : "disabled");
+    printf("\tDirected component: \t%s\n",
+           (p->use_scc) ? "strongly connected" : "weakly connected");
 
     print_separator();
 }
@@ -0,0 +1,267 @@
+/****************************************************************************
+ * @file dynbc.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Implementation of the incremental update of the betweenness
+ * centrality.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include "dynbc.h"
+
+/**
+ * @brief Packs a directed edge in a single key, ordered by row and then by
+ * column.
+ */
+static inline unsigned long long edge_key(int u, int v) {
+    return ((unsigned long long) u << 32) | (unsigned int) v;
+}
+
+/**
+ * @brief Builds the graph with sorted rows made of the edges of g plus the
+ * given ones, both directions of each undirected edge included, minus the
+ * ones with a key in the sorted array removed.
+ */
+static int build_graph(matrix_pcsr_t *g,
+                       const unsigned long long *removed,
+                       int nremoved,
+                       const edge_update_t *added,
+                       int nadded,
+                       matrix_pcsr_t *h,
+                       int nthreads) {
+
+    int nvertices = g->nrows;
+    int nnz = g->row_offsets[nvertices];
+    matrix_pcoo_t coo;
+
+    coo.nrows = nvertices;
+    coo.ncols = nvertices;
+    coo.nnz = 0;
+    coo.rows = (int *) malloc(max(nnz + 2 * nadded, 1) * sizeof(int));
+    coo.cols = (int *) malloc(max(nnz + 2 * nadded, 1) * sizeof(int));
+
+    if (coo.rows == 0 || coo.cols == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_matrix_pcoo(&coo);
+        return EXIT_FAILURE;
+    }
+
+    for (int v = 0; v < nvertices; v++) {
+        for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++) {
+            int w = g->cols[k];
+            if (nremoved > 0 && std::binary_search(removed, removed + nremoved,
+                                                   edge_key(v, w)))
+                continue;
+            coo.rows[coo.nnz] = v;
+            coo.cols[coo.nnz++] = w;
+        }
+    }
+
+    for (int i = 0; i < nadded; i++) {
+        coo.rows[coo.nnz] = added[i].u;
+        coo.cols[coo.nnz++] = added[i].v;
+        coo.rows[coo.nnz] = added[i].v;
+        coo.cols[coo.nnz++] = added[i].u;
+    }
+
+    /*
+     * Sorting the rows also merges the edges inserted twice.
+     */
+    int err = coo_to_csr_par(&coo, h, true, nthreads);
+    free_matrix_pcoo(&coo);
+
+    return err;
+}
+
+int init_dynbc(dynbc_t *dyn, matrix_pcsr_t *g, int nthreads) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    dyn->nthreads = nthreads;
+    dyn->bc_scores = (double *) malloc(max(g->nrows, 1) * sizeof(double));
+
+    if (dyn->bc_scores == 0 ||
+        build_graph(g, 0, 0, 0, 0, &dyn->g, nthreads) ||
+        compute_par_bc_cpu(&dyn->g, dyn->bc_scores, false, nthreads)) {
+        ZF_LOGF("Could not initialize the dynamic graph");
+        free(dyn->bc_scores);
+        dyn->bc_scores = 0;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void free_dynbc(dynbc_t *dyn) {
+    free_matrix_pcsr(&dyn->g);
+    free(dyn->bc_scores);
+    dyn->bc_scores = 0;
+}
+
+int update_dynbc(dynbc_t *dyn,
+                 const edge_update_t *updates,
+                 int nupdates,
+                 int *naffected) {
+
+    matrix_pcsr_t *g = &dyn->g;
+    int nvertices = g->nrows;
+
+    for (int i = 0; i < nupdates; i++) {
+        if (updates[i].u < 0 || updates[i].u >= nvertices ||
+            updates[i].v < 0 || updates[i].v >= nvertices) {
+            ZF_LOGE("Edge (%d, %d) out of the graph", updates[i].u,
+                    updates[i].v);
+            return EXIT_FAILURE;
+        }
+    }
+
+    auto *removed = (unsigned long long *) malloc(
+            max(2 * nupdates, 1) * sizeof(unsigned long long));
+    auto *added = (edge_update_t *) calloc(max(nupdates, 1),
+                                           sizeof(edge_update_t));
+    auto *mult = (int *) calloc(nvertices, sizeof(int));
+    auto *du = (int *) malloc(nvertices * sizeof(int));
+    auto *dv = (int *) malloc(nvertices * sizeof(int));
+    auto *old_dep = (double *) malloc(nvertices * sizeof(double));
+    auto *new_dep = (double *) malloc(nvertices * sizeof(double));
+    bfs_workspace_t ws;
+
+    if (removed == 0 || added == 0 || mult == 0 || du == 0 || dv == 0 ||
+        old_dep == 0 || new_dep == 0 || init_bfs_workspace(&ws, nvertices)) {
+        ZF_LOGF("Could not allocate memory");
+        free(removed);
+        free(added);
+        free(mult);
+        free(du);
+        free(dv);
+        free(old_dep);
+        free(new_dep);
+        return EXIT_FAILURE;
+    }
+
+    int nremoved = 0, nadded = 0;
+    for (int i = 0; i < nupdates; i++) {
+        int u = updates[i].u, v = updates[i].v;
+        if (u == v)
+            continue;
+
+        if (updates[i].insert) {
+            added[nadded++] = updates[i];
+        } else {
+            removed[nremoved++] = edge_key(u, v);
+            removed[nremoved++] = edge_key(v, u);
+        }
+    }
+    std::sort(removed, removed + nremoved);
+
+    /*
+     * A source whose distances to the endpoints of every updated edge are
+     * equal keeps its shortest paths, since none of them uses the edge. Two
+     * visits per edge cost more than visiting every source when the batch is
+     * large.
+     */
+    int nchanged = nadded + nremoved / 2;
+    int count = 0;
+
+    if (2 * nchanged >= nvertices) {
+        fill(mult, nvertices, 1);
+        count = nvertices;
+    } else {
+        for (int i = 0; i < nupdates; i++) {
+            int u = updates[i].u, v = updates[i].v;
+            if (u == v)
+                continue;
+
+            fill(du, nvertices, INT_MAX);
+            fill(dv, nvertices, INT_MAX);
+            BFS_visit_dir_opt(g, du, u, &ws);
+            BFS_visit_dir_opt(g, dv, v, &ws);
+
+            for (int s = 0; s < nvertices; s++) {
+                if (du[s] != dv[s] && mult[s] == 0) {
+                    mult[s] = 1;
+                    count++;
+                }
+            }
+        }
+    }
+
+    matrix_pcsr_t h;
+    h.row_offsets = 0;
+    h.cols = 0;
+    int err = build_graph(g, removed, nremoved, added, nadded, &h,
+                          dyn->nthreads);
+
+    /*
+     * The dependencies of the affected sources are replaced by the ones they
+     * have in the new graph. This takes two visits per source, so when most
+     * sources are affected the scores are computed again from scratch.
+     */
+    if (!err && 2 * count >= nvertices) {
+        err = compute_par_bc_cpu(&h, dyn->bc_scores, false, dyn->nthreads);
+    } else if (!err && count > 0) {
+        err = compute_multi_source_bc_cpu(g, mult, old_dep, dyn->nthreads) ||
+              compute_multi_source_bc_cpu(&h, mult, new_dep, dyn->nthreads);
+
+        if (!err) {
+            for (int v = 0; v < nvertices; v++)
+                dyn->bc_scores[v] += new_dep[v] - old_dep[v];
+        }
+    }
+
+    if (!err) {
+        free_matrix_pcsr(g);
+        *g = h;
+    } else {
+        ZF_LOGF("Could not update the betweenness");
+        free_matrix_pcsr(&h);
+    }
+
+    ZF_LOGI("Visited again %d of %d sources after %d updates", count,
+            nvertices, nupdates);
+
+    if (naffected != 0)
+        *naffected = count;
+
+    free_bfs_workspace(&ws);
+    free(removed);
+    free(added);
+    free(mult);
+    free(du);
+    free(dv);
+    free(old_dep);
+    free(new_dep);
+
+    return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -2,8 +2,8 @@
  * @file ecc.cpp
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Functions to compute the diameter of an undirected graph, the
- * eccentricity of its vertices and to get the graph density.
+ * @brief Functions to compute the diameter and the radius of an undirected
+ * graph, the eccentricity of its vertices and to get the graph density.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -36,37 +36,242 @@
 
 #include "ecc.h"
 
+#include <algorithm>
+
+/**
+ * @brief Eccentricity of s, INT_MAX if some vertex is unreachable. The
+ * distances from s are left in d and the vertices in ws->order.
+ */
+static int ecc_visit(matrix_pcsr_t *g, int s, int *d, bfs_workspace_t *ws,
+                     int *nvisits) {
+
+    fill(d, g->nrows, INT_MAX);
+    int ecc = BFS_visit_dir_opt(g, d, s, ws);
+    (*nvisits)++;
+
+    return (ws->nvisited < g->nrows) ? INT_MAX : ecc;
+}
+
+/**
+ * @brief Vertex halfway along a shortest path from a to the last vertex
+ * visited from a.
+ */
+static int get_middle_vertex(matrix_pcsr_t *g, int a, int *da, int *db,
+                             bfs_workspace_t *ws, int *nvisits, int *lb) {
+
+    int ecc_a = ecc_visit(g, a, da, ws, nvisits);
+    int b = ws->order[ws->nvisited - 1];
+    *lb = max(*lb, ecc_a);
+
+    ecc_visit(g, b, db, ws, nvisits);
+
+    int middle = a;
+    for (int v = 0; v < g->nrows; v++) {
+        if (da[v] == ecc_a / 2 && db[v] == ecc_a - ecc_a / 2) {
+            middle = v;
+            break;
+        }
+    }
+
+    return middle;
+}
+
 int get_diameter(matrix_pcsr_t *g) {
 
-    int max_distance;
-    int *eccentricity = (int *) malloc(g->nrows * sizeof(*eccentricity));
+    int nvertices = g->nrows;
+    bfs_workspace_t ws;
+
+    auto *d = (int *) malloc(nvertices * sizeof(int));
+    auto *d_aux = (int *) malloc(nvertices * sizeof(int));
+    auto *fringe = (int *) malloc(nvertices * sizeof(int));
+    auto *level = (int *) malloc(nvertices * sizeof(int));
 
-    if (eccentricity == 0) {
+    if (d == 0 || d_aux == 0 || fringe == 0 || level == 0 ||
+        init_bfs_workspace(&ws, nvertices)) {
         ZF_LOGF("Could not allocate memory");
+        free(d);
+        free(d_aux);
+        free(fringe);
+        free(level);
         return -1;
     }
 
-    get_vertices_eccentricity(g, eccentricity);
-    max_distance = eccentricity[argmax(eccentricity, g->nrows)];
-    free(eccentricity);
+    int nvisits = 0, lb = 0, r = 0;
+
+    /*
+     * The first sweep starts from the vertex with the highest degree.
+     */
+    for (int v = 1; v < nvertices; v++) {
+        if (g->row_offsets[v + 1] - g->row_offsets[v] >
+            g->row_offsets[r + 1] - g->row_offsets[r])
+            r = v;
+    }
+
+    int diameter;
+    if (nvertices == 0) {
+        diameter = 0;
+    } else if (ecc_visit(g, r, d, &ws, &nvisits) == INT_MAX) {
+        diameter = INT_MAX;
+    } else {
+        /*
+         * 4-sweep: two double sweeps give a lower bound and a vertex u close
+         * to the center of the graph.
+         */
+        int a = ws.order[ws.nvisited - 1];
+        int r2 = get_middle_vertex(g, a, d, d_aux, &ws, &nvisits, &lb);
+
+        ecc_visit(g, r2, d, &ws, &nvisits);
+        a = ws.order[ws.nvisited - 1];
+        int u = get_middle_vertex(g, a, d, d_aux, &ws, &nvisits, &lb);
+
+        /*
+         * iFUB: the fringes at distance i from u are visited from the
+         * farthest. Two vertices at distance at most i from u are at most 2i
+         * apart, so once the fringes farther than i are visited the diameter
+         * is at most 2i: a whole fringe is visited unless the lower bound
+         * reaches 2i, and the search stops as soon as the lower bound
+         * exceeds 2 * (i - 1), the bound of the closer vertices.
+         */
+        int ecc_u = ecc_visit(g, u, d, &ws, &nvisits);
+        lb = max(lb, ecc_u);
+        std::copy(ws.order, ws.order + nvertices, fringe);
+        std::copy(d, d + nvertices, level);
+
+        int ub = 2 * ecc_u;
+        int end = nvertices;
+
+        for (int i = ecc_u; ub > lb && i > 0; i--) {
+
+            int begin = end;
+            while (begin > 0 && level[fringe[begin - 1]] == i)
+                begin--;
+
+            for (int j = begin; j < end && lb < 2 * i; j++)
+                lb = max(lb, ecc_visit(g, fringe[j], d_aux, &ws, &nvisits));
+
+            ub = 2 * (i - 1);
+            end = begin;
+        }
+
+        diameter = lb;
+    }
+
+    ZF_LOGI("Diameter computed with %d visits inspecting %llu edges",
+            nvisits, ws.nedges_inspected);
+
+    free_bfs_workspace(&ws);
+    free(d);
+    free(d_aux);
+    free(fringe);
+    free(level);
 
-    return max_distance;
+    return diameter;
+}
+
+int get_radius(matrix_pcsr_t *g) {
+
+    int nvertices = g->nrows;
+    bfs_workspace_t ws;
+
+    auto *d = (int *) malloc(nvertices * sizeof(int));
+    auto *ecc_lower = (int *) calloc(nvertices, sizeof(int));
+    auto *is_candidate = (bool *) malloc(nvertices * sizeof(bool));
+
+    if (d == 0 || ecc_lower == 0 || is_candidate == 0 ||
+        init_bfs_workspace(&ws, nvertices)) {
+        ZF_LOGF("Could not allocate memory");
+        free(d);
+        free(ecc_lower);
+        free(is_candidate);
+        return -1;
+    }
+
+    for (int v = 0; v < nvertices; v++)
+        is_candidate[v] = true;
+
+    /*
+     * Eccentricity bounds as proposed by Takes and Kosters: after a visit
+     * from w, ecc(v) >= max(d(w, v), ecc(w) - d(w, v)). Vertices whose lower
+     * bound reaches the best eccentricity found so far cannot be the center
+     * and the next visit starts from the lowest bound, from the highest
+     * degree among ties.
+     */
+    int radius = (nvertices == 0) ? 0 : INT_MAX;
+    int nvisits = 0;
+    int w = -1;
+
+    do {
+        w = -1;
+        for (int v = 0; v < nvertices; v++) {
+            if (!is_candidate[v] || ecc_lower[v] >= radius)
+                continue;
+
+            int deg_v = g->row_offsets[v + 1] - g->row_offsets[v];
+            if (w == -1 || ecc_lower[v] < ecc_lower[w] ||
+                (ecc_lower[v] == ecc_lower[w] &&
+                 deg_v > g->row_offsets[w + 1] - g->row_offsets[w]))
+                w = v;
+        }
+
+        if (w == -1)
+            break;
+
+        int ecc_w = ecc_visit(g, w, d, &ws, &nvisits);
+        is_candidate[w] = false;
+
+        /*
+         * Every eccentricity is infinite in a disconnected graph.
+         */
+        if (ecc_w == INT_MAX)
+            break;
+
+        radius = min(radius, ecc_w);
+
+        for (int v = 0; v < nvertices; v++)
+            ecc_lower[v] = max(ecc_lower[v], max(d[v], ecc_w - d[v]));
+
+    } while (true);
+
+    ZF_LOGI("Radius computed with %d visits inspecting %llu edges",
+            nvisits, ws.nedges_inspected);
+
+    free_bfs_workspace(&ws);
+    free(d);
+    free(ecc_lower);
+    free(is_candidate);
+
+    return radius;
 }
 
 int get_vertices_eccentricity(matrix_pcsr_t *g, int *eccentricity) {
 
+    bfs_workspace_t ws;
+
     auto *d = (int *) malloc(g->nrows * sizeof(int));
-    if(d == 0) {
+    if(d == 0 || init_bfs_workspace(&ws, g->nrows)) {
         ZF_LOGF("Could not allocate memory");
+        free(d);
         return EXIT_FAILURE;
     }
 
+    fill(d, g->nrows, INT_MAX);
+
     for (int i = 0; i < g->nrows; i++) {
-        fill(d, g->nrows, INT_MAX);
-        BFS_visit(g, d, i);
-        eccentricity[i] = d[argmax(d, g->nrows)];
+        int ecc = BFS_visit_dir_opt(g, d, i, &ws);
+
+        /*
+         * The eccentricity is infinite if some vertex is unreachable.
+         */
+        eccentricity[i] = (ws.nvisited < g->nrows) ? INT_MAX : ecc;
+
+        for (int j = 0; j < ws.nvisited; j++)
+            d[ws.order[j]] = INT_MAX;
     }
 
+    ZF_LOGI("Eccentricities computed by inspecting %llu edges",
+            ws.nedges_inspected);
+
+    free_bfs_workspace(&ws);
     free(d);
     return EXIT_SUCCESS;
 }
@@ -2,7 +2,7 @@
  * @file graphs.cpp
  * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
  *
- * @brief Algorithms for undirected unweighted graphs manipulation.
+ * @brief Algorithms for unweighted graphs manipulation.
  *
  * Copyright 2021 (c) 2021 by Riccardo Battistini
  *
@@ -50,9 +50,36 @@ void print_graph_overview(matrix_pcsr_t *g, int *degree) {
     printf("\tMax degree: \t\t%d\n", degree[argmax(degree, nvertices)]);
 
     /*
-     * Exact serial unoptimized slow diameter computation.
+     * The whole graph is kept when it is disconnected only for the
+     * closeness variants, its diameter and radius are then infinite.
      */
-//    printf("\tDiameter: \t\t%d\n", get_diameter(g));
+    int diameter = get_diameter(g);
+    if (diameter == INT_MAX) {
+        printf("\tDiameter: \t\tinfinite\n");
+        printf("\tRadius: \t\tinfinite\n");
+    } else {
+        printf("\tDiameter: \t\t%d\n", diameter);
+        printf("\tRadius: \t\t%d\n", get_radius(g));
+    }
+
+    print_separator();
+}
+
+void print_directed_graph_overview(matrix_pcsr_t *g, int *in_degree,
+                                   int *out_degree) {
+
+    int nvertices = g->nrows;
+    int nedges = g->row_offsets[g->nrows];
+
+    printf("Graph overview:\n\n");
+    printf("\tVertices:\t\t%d\n", nvertices);
+    printf("\tArcs:\t\t\t%d\n", nedges);
+    printf("\tDensity:\t\t%f %%\n",
+           get_density(nvertices, nedges) * 50);
+    printf("\tMax in-degree: \t\t%d\n",
+           in_degree[argmax(in_degree, nvertices)]);
+    printf("\tMax out-degree: \t%d\n",
+           out_degree[argmax(out_degree, nvertices)]);
 
     print_separator();
 }
@@ -62,7 +89,9 @@ void print_graph_properties(gprops_t *gp) {
     printf("Graph properties:\n\n");
     printf("\tDirected: \t\t%s\n", (gp->is_directed == 1) ? "yes" : "no");
     printf("\tWeighted: \t\t%s\n", (gp->is_weighted == 1) ? "yes" : "no");
-    printf("\tConnected: \t\t%s\n", (gp->is_connected == 1) ? "yes" : "no");
+    printf("\tConnected: \t\t%s\n", (gp->is_connected == 1) ? "yes" :
+                                      (gp->is_connected == 0) ? "no" :
+                                      "not checked");
     printf("\tHas self loops: \t%s\n", (gp->has_self_loops == 1) ? "yes" : "no");
 
     print_separator();
@@ -167,6 +196,506 @@ void BFS_visit(matrix_pcsr_t *g, int *d, int s) {
     }
 }
 
+int init_bfs_workspace(bfs_workspace_t *ws, int nvertices) {
+
+    size_t nwords = (nvertices + 63) / 64;
+
+    ws->nvertices = nvertices;
+    ws->nvisited = 0;
+    ws->nedges_inspected = 0;
+    ws->bu_inspected = 0;
+    ws->bu_saved = 0;
+    ws->order = (int *) malloc(nvertices * sizeof(int));
+    ws->frontier = (unsigned long long *) calloc(nwords,
+                                                 sizeof(unsigned long long));
+
+    if (ws->order == 0 || ws->frontier == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_bfs_workspace(ws);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void free_bfs_workspace(bfs_workspace_t *ws) {
+    free(ws->order);
+    free(ws->frontier);
+    ws->order = 0;
+    ws->frontier = 0;
+    ws->nvertices = 0;
+}
+
+int BFS_visit_dir_opt(matrix_pcsr_t *g, int *d, int s, bfs_workspace_t *ws) {
+
+    int nvertices = g->nrows;
+    const int *row_offsets = g->row_offsets;
+    const int *cols = g->cols;
+    int *order = ws->order;
+    unsigned long long *frontier = ws->frontier;
+    unsigned long long ninspected = 0;
+
+    /*
+     * Edges of the vertices not yet visited.
+     */
+    long long unexplored_edges =
+            row_offsets[nvertices] - (row_offsets[s + 1] - row_offsets[s]);
+    bool bottom_up = false;
+    bool bottom_up_allowed = ws->bu_inspected <= ws->bu_saved;
+
+    /*
+     * The frontier of the current level is the range [head, level_end) of the
+     * order array and the next frontier is appended after it.
+     */
+    int head = 0, tail = 0, depth = 0, prev_frontier_size = 0;
+    d[s] = 0;
+    order[tail++] = s;
+
+    while (head < tail) {
+
+        int level_end = tail;
+        int frontier_size = level_end - head;
+        long long frontier_edges = 0;
+
+        for (int i = head; i < level_end; i++) {
+            int v = order[i];
+            frontier_edges += row_offsets[v + 1] - row_offsets[v];
+        }
+
+        /*
+         * Go bottom-up only while the frontier is growing and back top-down
+         * once it is shrinking and small.
+         */
+        if (!bottom_up) {
+            bottom_up = bottom_up_allowed &&
+                        frontier_size > prev_frontier_size &&
+                        frontier_edges > unexplored_edges / BFS_ALPHA;
+        } else {
+            bottom_up = frontier_size >= prev_frontier_size ||
+                        frontier_size >= nvertices / BFS_BETA;
+        }
+        prev_frontier_size = frontier_size;
+
+        if (!bottom_up) {
+
+            for (int i = head; i < level_end; i++) {
+                int v = order[i];
+
+                for (int k = row_offsets[v]; k < row_offsets[v + 1]; k++) {
+                    int w = cols[k];
+                    ninspected++;
+
+                    if (d[w] == INT_MAX) {
+                        d[w] = depth + 1;
+                        order[tail++] = w;
+                        unexplored_edges -=
+                                row_offsets[w + 1] - row_offsets[w];
+                    }
+                }
+            }
+        } else {
+
+            unsigned long long ninspected_level = ninspected;
+
+            for (int i = head; i < level_end; i++) {
+                int v = order[i];
+                frontier[v >> 6] |= 1ULL << (v & 63);
+            }
+
+            /*
+             * Each unvisited vertex looks for a parent in the frontier and
+             * stops at the first one.
+             */
+            for (int w = 0; w < nvertices; w++) {
+                if (d[w] != INT_MAX)
+                    continue;
+
+                for (int k = row_offsets[w]; k < row_offsets[w + 1]; k++) {
+                    int v = cols[k];
+                    ninspected++;
+
+                    if (frontier[v >> 6] & (1ULL << (v & 63))) {
+                        d[w] = depth + 1;
+                        order[tail++] = w;
+                        unexplored_edges -=
+                                row_offsets[w + 1] - row_offsets[w];
+                        break;
+                    }
+                }
+            }
+
+            for (int i = head; i < level_end; i++) {
+                int v = order[i];
+                frontier[v >> 6] = 0;
+            }
+
+            /*
+             * On graphs with high clustering, such as lattices, unvisited
+             * vertices rarely have a parent in the frontier. If a bottom-up
+             * step costs more than the top-down one the rest of the visit
+             * is done top-down.
+             */
+            ninspected_level = ninspected - ninspected_level;
+            ws->bu_inspected += ninspected_level;
+            ws->bu_saved += frontier_edges;
+
+            if (ninspected_level > (unsigned long long) frontier_edges) {
+                bottom_up = false;
+                bottom_up_allowed = false;
+            }
+        }
+
+        head = level_end;
+        depth++;
+    }
+
+    ws->nvisited = tail;
+    ws->nedges_inspected += ninspected;
+
+    return d[order[tail - 1]];
+}
+
+int get_cc_bfs(matrix_pcsr_t *g, components_t *ccs) {
+
+    int nvertices = g->nrows;
+    bfs_workspace_t ws;
+
+    auto d = (int *) malloc(nvertices * sizeof(int));
+    auto cc_array = (int *) malloc(nvertices * sizeof(int));
+    auto cc_size = (int *) malloc(nvertices * sizeof(int));
+
+    if (d == 0 || cc_array == 0 || cc_size == 0 ||
+        init_bfs_workspace(&ws, nvertices)) {
+        ZF_LOGF("Could not allocate memory");
+        free(d);
+        free(cc_array);
+        free(cc_size);
+        return EXIT_FAILURE;
+    }
+
+    fill(d, nvertices, INT_MAX);
+
+    int cc_count = 0, nvisited = 0;
+
+    for (int i = 0; i < nvertices; i++) {
+        if (d[i] == INT_MAX) {
+            BFS_visit_dir_opt(g, d, i, &ws);
+
+            memcpy(cc_array + nvisited, ws.order, ws.nvisited * sizeof(int));
+            cc_size[cc_count] = ws.nvisited;
+            nvisited += ws.nvisited;
+            cc_count++;
+        }
+    }
+
+    ZF_LOGI("Connected components found by inspecting %llu edges",
+            ws.nedges_inspected);
+
+    free(d);
+    free_bfs_workspace(&ws);
+
+    ccs->array = cc_array;
+    ccs->cc_size = (int *) realloc(cc_size, cc_count * sizeof(int));
+    ccs->cc_count = cc_count;
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Merge the trees of u and v, hooking the higher root on the lower
+ * one with a compare-and-swap, so that the root of a tree is always its
+ * smallest vertex.
+ */
+static void link_vertices(int u, int v, int *comp) {
+
+    int p1 = comp[u];
+    int p2 = comp[v];
+
+    while (p1 != p2) {
+        int high = max(p1, p2);
+        int low = p1 + p2 - high;
+        int p_high = comp[high];
+
+        if (p_high == low ||
+            (p_high == high &&
+             __sync_bool_compare_and_swap(&comp[high], high, low)))
+            break;
+
+        p1 = comp[comp[high]];
+        p2 = comp[low];
+    }
+}
+
+/**
+ * @brief Make every vertex point directly to the root of its tree.
+ */
+static void compress_labels(int *comp, int nvertices, int nthreads) {
+
+#pragma omp parallel for schedule(dynamic, 16384) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++) {
+        while (comp[v] != comp[comp[v]])
+            comp[v] = comp[comp[v]];
+    }
+}
+
+/**
+ * @brief Find the most frequent label among a sample of the vertices, -1 if
+ * there are no vertices.
+ */
+static int sample_frequent_label(const int *comp, int nvertices) {
+
+    if (nvertices == 0)
+        return -1;
+
+    std::vector<int> samples(AFFOREST_SAMPLES);
+    unsigned long long state = 0x9E3779B97F4A7C15ULL;
+
+    for (int k = 0; k < AFFOREST_SAMPLES; k++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        samples[k] = comp[(state >> 33) % nvertices];
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    int best = samples[0], best_count = 0;
+    for (int k = 0, count = 0; k < AFFOREST_SAMPLES; k++) {
+        count = (k > 0 && samples[k] == samples[k - 1]) ? count + 1 : 1;
+        if (count > best_count) {
+            best_count = count;
+            best = samples[k];
+        }
+    }
+
+    return best;
+}
+
+/**
+ * @brief Afforest with the option of linking every edge, as needed by
+ * directed graphs whose edges are stored in one direction only.
+ */
+static int afforest(matrix_pcsr_t *g, components_t *ccs, bool skip_frequent,
+                    int nthreads) {
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int nvertices = g->nrows;
+    auto *comp = (int *) malloc(nvertices * sizeof(int));
+
+    if (comp == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++)
+        comp[v] = v;
+
+    /*
+     * Link a few neighbors of each vertex, which is usually enough to
+     * find most of the largest component.
+     */
+    for (int r = 0; r < AFFOREST_ROUNDS; r++) {
+#pragma omp parallel for schedule(dynamic, 16384) num_threads(nthreads)
+        for (int v = 0; v < nvertices; v++) {
+            int k = g->row_offsets[v] + r;
+            if (k < g->row_offsets[v + 1])
+                link_vertices(v, g->cols[k], comp);
+        }
+        compress_labels(comp, nvertices, nthreads);
+    }
+
+    /*
+     * The remaining edges of the vertices of the most frequent component
+     * can be skipped, since the other endpoint, if it is not already in
+     * that component, links itself to it.
+     */
+    int c = skip_frequent ? sample_frequent_label(comp, nvertices) : -1;
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++) {
+        if (comp[v] == c)
+            continue;
+        for (int k = g->row_offsets[v] + AFFOREST_ROUNDS;
+             k < g->row_offsets[v + 1]; k++)
+            link_vertices(v, g->cols[k], comp);
+    }
+    compress_labels(comp, nvertices, nthreads);
+
+    /*
+     * Number the components by their root, which is their smallest vertex,
+     * and group the vertices with a counting sort.
+     */
+    matrix_pcoo_t labels;
+    matrix_pcsr_t groups;
+    auto *cc_id = (int *) malloc((nvertices + 1) * sizeof(int));
+    auto *vertices = (int *) malloc(nvertices * sizeof(int));
+
+    if (cc_id == 0 || vertices == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(comp);
+        free(cc_id);
+        free(vertices);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++) {
+        cc_id[v] = (comp[v] == v);
+        vertices[v] = v;
+    }
+
+    int cc_count = exclusive_scan_par(cc_id, nvertices, nthreads);
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++)
+        comp[v] = cc_id[comp[v]];
+
+    labels.nrows = cc_count;
+    labels.ncols = nvertices;
+    labels.nnz = nvertices;
+    labels.rows = comp;
+    labels.cols = vertices;
+
+    int err = coo_to_csr_par(&labels, &groups, false, nthreads);
+
+    free(comp);
+    free(vertices);
+
+    if (err) {
+        free(cc_id);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * The row offsets of the groups become the sizes of the components.
+     */
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int i = 0; i < cc_count; i++)
+        cc_id[i] = groups.row_offsets[i + 1] - groups.row_offsets[i];
+
+    free(groups.row_offsets);
+
+    ccs->array = groups.cols;
+    ccs->cc_size = (int *) realloc(cc_id, max(cc_count, 1) * sizeof(int));
+    ccs->cc_count = cc_count;
+
+    return EXIT_SUCCESS;
+}
+
+int get_cc_afforest(matrix_pcsr_t *g, components_t *ccs, int nthreads) {
+    return afforest(g, ccs, true, nthreads);
+}
+
+int get_wcc(matrix_pcsr_t *g, components_t *ccs, int nthreads) {
+
+    /*
+     * An edge from the most frequent component can be the only one that
+     * reaches a vertex, hence no edge is skipped.
+     */
+    return afforest(g, ccs, false, nthreads);
+}
+
+int get_scc(matrix_pcsr_t *g, components_t *ccs) {
+
+    int nvertices = g->nrows;
+
+    auto *index = (int *) malloc(nvertices * sizeof(int));
+    auto *low = (int *) malloc(nvertices * sizeof(int));
+    auto *next = (int *) malloc(nvertices * sizeof(int));
+    auto *call_stack = (int *) malloc(nvertices * sizeof(int));
+    auto *stack = (int *) malloc(nvertices * sizeof(int));
+    auto *on_stack = (bool *) calloc(nvertices, sizeof(bool));
+    auto *array = (int *) malloc(nvertices * sizeof(int));
+    auto *cc_size = (int *) malloc(nvertices * sizeof(int));
+
+    if (index == 0 || low == 0 || next == 0 || call_stack == 0 ||
+        stack == 0 || on_stack == 0 || array == 0 || cc_size == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(index);
+        free(low);
+        free(next);
+        free(call_stack);
+        free(stack);
+        free(on_stack);
+        free(array);
+        free(cc_size);
+        return EXIT_FAILURE;
+    }
+
+    fill(index, nvertices, -1);
+
+    /*
+     * Iterative Tarjan algorithm, next holds the position of the next edge
+     * to follow of each vertex on the call stack.
+     */
+    int counter = 0, top = 0, ncalls = 0, nstored = 0, cc_count = 0;
+
+    for (int r = 0; r < nvertices; r++) {
+        if (index[r] != -1)
+            continue;
+
+        index[r] = low[r] = counter++;
+        next[r] = g->row_offsets[r];
+        stack[top++] = r;
+        on_stack[r] = true;
+        call_stack[ncalls++] = r;
+
+        while (ncalls > 0) {
+            int v = call_stack[ncalls - 1];
+
+            if (next[v] < g->row_offsets[v + 1]) {
+                int w = g->cols[next[v]++];
+
+                if (index[w] == -1) {
+                    index[w] = low[w] = counter++;
+                    next[w] = g->row_offsets[w];
+                    stack[top++] = w;
+                    on_stack[w] = true;
+                    call_stack[ncalls++] = w;
+                } else if (on_stack[w]) {
+                    low[v] = min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            ncalls--;
+            if (ncalls > 0) {
+                int u = call_stack[ncalls - 1];
+                low[u] = min(low[u], low[v]);
+            }
+
+            /*
+             * v is the root of a component, made of the vertices above it
+             * on the stack.
+             */
+            if (low[v] == index[v]) {
+                int size = 0, w;
+                do {
+                    w = stack[--top];
+                    on_stack[w] = false;
+                    array[nstored++] = w;
+                    size++;
+                } while (w != v);
+                cc_size[cc_count++] = size;
+            }
+        }
+    }
+
+    ccs->array = array;
+    ccs->cc_size = (int *) realloc(cc_size, max(cc_count, 1) * sizeof(int));
+    ccs->cc_count = cc_count;
+
+    free(index);
+    free(low);
+    free(next);
+    free(call_stack);
+    free(stack);
+    free(on_stack);
+
+    return EXIT_SUCCESS;
+}
+
 void extract_subgraph(const int *vertices,
                       int nvertices,
                       matrix_pcsr_t *A,
@@ -182,7 +711,223 @@ void extract_subgraph(const int *vertices,
     free_matrix_pcsr(&Q);
 }
 
-void get_largest_cc(matrix_pcsr_t *A, matrix_pcsr_t *C, components_t *ccs) {
+/**
+ * @brief Get the marker array of the calling thread, allocating it and
+ * setting its entries to -1 the first time.
+ */
+static int *get_thread_marks(int **marks, int nvertices) {
+
+    int **mark = &marks[omp_get_thread_num()];
+
+    if (*mark == 0) {
+        *mark = (int *) malloc(max(nvertices, 1) * sizeof(int));
+        if (*mark != 0)
+            std::fill(*mark, *mark + nvertices, -1);
+    }
+
+    return *mark;
+}
+
+/**
+ * @brief Filter the i-th row, the one of v, through the old-to-new id map
+ * keeping only the first occurrence of each new id, which is stamped with
+ * i in mark. The stamps are cleared before returning.
+ *
+ * @return the number of entries of the filtered row, which are stored in
+ * cols unless it is 0
+ */
+static int dedup_row(const matrix_pcsr_t *A,
+                     int v,
+                     int i,
+                     const int *new_id,
+                     int *mark,
+                     int *cols) {
+
+    int count = 0;
+
+    for (int k = A->row_offsets[v]; k < A->row_offsets[v + 1]; k++) {
+        int w = new_id[A->cols[k]];
+        if (w >= 0 && mark[w] != i) {
+            mark[w] = i;
+            if (cols != 0)
+                cols[count] = w;
+            count++;
+        }
+    }
+
+    for (int k = A->row_offsets[v]; k < A->row_offsets[v + 1]; k++) {
+        int w = new_id[A->cols[k]];
+        if (w >= 0)
+            mark[w] = -1;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Filter the rows of the given vertices through the old-to-new id
+ * map, whose entries must be -1 but for the ones of the vertices.
+ *
+ * Duplicated entries of a row are skipped as SpRef does, keeping the first
+ * one. Since the map is injective on the vertices, a row whose columns are
+ * strictly increasing has no duplicates and is copied in a single pass.
+ * The other rows are deduplicated with a marker array of the thread, which
+ * is allocated only by the threads that meet one of them.
+ */
+static int relabel_rows(const int *vertices,
+                        int nvertices,
+                        matrix_pcsr_t *A,
+                        matrix_pcsr_t *C,
+                        const int *new_id,
+                        int nthreads) {
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *row_offsets = (int *) malloc((nvertices + 1) * sizeof(int));
+    auto *increasing = (char *) malloc(max(nvertices, 1) * sizeof(char));
+    auto **marks = (int **) calloc(nthreads, sizeof(int *));
+
+    if (row_offsets == 0 || increasing == 0 || marks == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(row_offsets);
+        free(increasing);
+        free(marks);
+        return EXIT_FAILURE;
+    }
+
+    int err = EXIT_SUCCESS;
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for (int i = 0; i < nvertices; i++) {
+        int v = vertices[i], count = 0;
+        bool inc = true;
+
+        for (int k = A->row_offsets[v]; k < A->row_offsets[v + 1]; k++) {
+            if (k > A->row_offsets[v] && A->cols[k] <= A->cols[k - 1])
+                inc = false;
+            if (new_id[A->cols[k]] >= 0)
+                count++;
+        }
+
+        if (!inc) {
+            int *mark = get_thread_marks(marks, nvertices);
+            if (mark != 0) {
+                count = dedup_row(A, v, i, new_id, mark, 0);
+            } else {
+#pragma omp atomic write
+                err = EXIT_FAILURE;
+            }
+        }
+
+        increasing[i] = inc;
+        row_offsets[i] = count;
+    }
+
+    int nnz = exclusive_scan_par(row_offsets, nvertices, nthreads);
+    row_offsets[nvertices] = nnz;
+
+    auto *cols = (int *) malloc(max(nnz, 1) * sizeof(int));
+    if (cols == 0)
+        err = EXIT_FAILURE;
+
+    if (err == EXIT_SUCCESS) {
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+        for (int i = 0; i < nvertices; i++) {
+            int v = vertices[i], dest = row_offsets[i];
+
+            if (increasing[i]) {
+                for (int k = A->row_offsets[v]; k < A->row_offsets[v + 1];
+                     k++) {
+                    int w = new_id[A->cols[k]];
+                    if (w >= 0)
+                        cols[dest++] = w;
+                }
+            } else {
+                int *mark = get_thread_marks(marks, nvertices);
+                if (mark != 0) {
+                    dedup_row(A, v, i, new_id, mark, cols + dest);
+                } else {
+#pragma omp atomic write
+                    err = EXIT_FAILURE;
+                }
+            }
+        }
+    }
+
+    for (int t = 0; t < nthreads; t++)
+        free(marks[t]);
+    free(marks);
+    free(increasing);
+
+    if (err) {
+        ZF_LOGF("Could not allocate memory");
+        free(row_offsets);
+        free(cols);
+        return EXIT_FAILURE;
+    }
+
+    C->nrows = nvertices;
+    C->ncols = nvertices;
+    C->row_offsets = row_offsets;
+    C->cols = cols;
+
+    return EXIT_SUCCESS;
+}
+
+int extract_subgraph_relabel(const int *vertices,
+                             int nvertices,
+                             matrix_pcsr_t *A,
+                             matrix_pcsr_t *C,
+                             int nthreads) {
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    auto *new_id = (int *) malloc(A->ncols * sizeof(int));
+
+    if (new_id == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel num_threads(nthreads)
+    {
+#pragma omp for schedule(static)
+        for (int v = 0; v < A->ncols; v++)
+            new_id[v] = -1;
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < nvertices; i++)
+            new_id[vertices[i]] = i;
+    }
+
+    int err = relabel_rows(vertices, nvertices, A, C, new_id, nthreads);
+
+    free(new_id);
+
+    return err;
+}
+
+int extract_subgraph_map(const int *vertices,
+                         int nvertices,
+                         matrix_pcsr_t *A,
+                         matrix_pcsr_t *C,
+                         int *new_id) {
+
+    for (int i = 0; i < nvertices; i++)
+        new_id[vertices[i]] = i;
+
+    int err = relabel_rows(vertices, nvertices, A, C, new_id, 1);
+
+    for (int i = 0; i < nvertices; i++)
+        new_id[vertices[i]] = -1;
+
+    return err;
+}
+
+void get_largest_cc(matrix_pcsr_t *A, matrix_pcsr_t *C, components_t *ccs,
+                    int nthreads) {
 
     int max_idx = argmax(ccs->cc_size, ccs->cc_count);
     int largest_cc_size = ccs->cc_size[max_idx];
@@ -211,7 +956,8 @@ void get_largest_cc(matrix_pcsr_t *A, matrix_pcsr_t *C, components_t *ccs) {
         largest_cc_vertices[j] = ccs->array[i];
 
     std::sort(largest_cc_vertices, largest_cc_vertices + largest_cc_size);
-    extract_subgraph(largest_cc_vertices, largest_cc_size, A, C);
+    extract_subgraph_relabel(largest_cc_vertices, largest_cc_size, A, C,
+                             nthreads);
     free(largest_cc_vertices);
 }
 
@@ -208,6 +208,57 @@ int coo_to_csr(matrix_pcoo_t *A, matrix_pcsr_t *B) {
     return EXIT_SUCCESS;
 }
 
+int rcoo_to_rcsr(matrix_rcoo_t *A, matrix_rcsr_t *B) {
+
+    if (!check_matrix_rcoo(A)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nnz = A->nnz;
+    int nrows = A->nrows;
+
+    auto *row_offsets = (int *) calloc((nrows + 1), sizeof(int));
+    auto *cols = (int *) malloc(nnz * sizeof(int));
+    auto *weights = (int *) malloc(nnz * sizeof(int));
+
+    if (row_offsets == 0 || cols == 0 || weights == 0) {
+        ZF_LOGF("Memory allocation failed!");
+        free(row_offsets);
+        free(cols);
+        free(weights);
+        return EXIT_FAILURE;
+    }
+
+    for (int n = 0; n < nnz; n++)
+        row_offsets[A->rows[n] + 1]++;
+
+    for (int i = 0; i < nrows; i++)
+        row_offsets[i + 1] += row_offsets[i];
+
+    /*
+     * Each weight follows its column index, the row offsets are shifted
+     * back by one position at the end.
+     */
+    for (int n = 0; n < nnz; n++) {
+        int dest = row_offsets[A->rows[n]]++;
+        cols[dest] = A->cols[n];
+        weights[dest] = A->weights[n];
+    }
+
+    for (int i = nrows; i > 0; i--)
+        row_offsets[i] = row_offsets[i - 1];
+    row_offsets[0] = 0;
+
+    B->nrows = nrows;
+    B->ncols = A->ncols;
+    B->row_offsets = row_offsets;
+    B->cols = cols;
+    B->weights = weights;
+
+    return EXIT_SUCCESS;
+}
+
 int transpose(matrix_pcsr_t *A, matrix_pcsr_t *B) {
 
     if (!check_matrix_pcsr(A)) {
@@ -270,3 +321,275 @@ int transpose(matrix_pcsr_t *A, matrix_pcsr_t *B) {
 
     return EXIT_SUCCESS;
 }
+
+int exclusive_scan_par(int *a, int n, int nthreads) {
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int nblocks = max(1, min(nthreads, n / 4096));
+    auto *block_sums = (int *) calloc(nblocks + 1, sizeof(int));
+    assert(block_sums);
+
+    /*
+     * Scan each block locally, then shift it by the sum of the previous
+     * blocks.
+     */
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 0; b < nblocks; b++) {
+        int begin = (int) ((long long) n * b / nblocks);
+        int end = (int) ((long long) n * (b + 1) / nblocks);
+        int psum = 0;
+        for (int i = begin; i < end; i++) {
+            int temp = a[i];
+            a[i] = psum;
+            psum += temp;
+        }
+        block_sums[b + 1] = psum;
+    }
+
+    for (int b = 0; b < nblocks; b++)
+        block_sums[b + 1] += block_sums[b];
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 1; b < nblocks; b++) {
+        int begin = (int) ((long long) n * b / nblocks);
+        int end = (int) ((long long) n * (b + 1) / nblocks);
+        for (int i = begin; i < end; i++)
+            a[i] += block_sums[b];
+    }
+
+    int total = block_sums[nblocks];
+    free(block_sums);
+
+    return total;
+}
+
+/**
+ * @brief Turn per-block histograms, stored contiguously for each block,
+ * into the offsets where each block scatters its first entry of each row.
+ *
+ * @return the number of entries
+ */
+static int histograms_to_offsets(int *hist, int nblocks, int nrows,
+                                 int *row_offsets, int nthreads) {
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int i = 0; i < nrows; i++) {
+        int psum = 0;
+        for (int b = 0; b < nblocks; b++) {
+            int temp = hist[(size_t) b * nrows + i];
+            hist[(size_t) b * nrows + i] = psum;
+            psum += temp;
+        }
+        row_offsets[i] = psum;
+    }
+
+    int nnz = exclusive_scan_par(row_offsets, nrows, nthreads);
+    row_offsets[nrows] = nnz;
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int i = 0; i < nrows; i++) {
+        for (int b = 0; b < nblocks; b++)
+            hist[(size_t) b * nrows + i] += row_offsets[i];
+    }
+
+    return nnz;
+}
+
+/**
+ * @brief Sort the column indices of each row and remove duplicates,
+ * compacting the arrays of the matrix.
+ */
+static int sort_dedup_rows(matrix_pcsr_t *B, int nthreads) {
+
+    int nrows = B->nrows;
+    auto *counts = (int *) malloc((nrows + 1) * sizeof(int));
+
+    if (counts == 0) {
+        ZF_LOGF("Memory allocation failed!");
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for (int i = 0; i < nrows; i++) {
+        int *first = B->cols + B->row_offsets[i];
+        int *last = B->cols + B->row_offsets[i + 1];
+        std::sort(first, last);
+        counts[i] = (int) (std::unique(first, last) - first);
+    }
+
+    int nnz = exclusive_scan_par(counts, nrows, nthreads);
+    counts[nrows] = nnz;
+
+    if (nnz == B->row_offsets[nrows]) {
+        free(counts);
+        return EXIT_SUCCESS;
+    }
+
+    auto *cols = (int *) malloc(max(nnz, 1) * sizeof(int));
+    if (cols == 0) {
+        ZF_LOGF("Memory allocation failed!");
+        free(counts);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for (int i = 0; i < nrows; i++) {
+        memcpy(cols + counts[i], B->cols + B->row_offsets[i],
+               (counts[i + 1] - counts[i]) * sizeof(int));
+    }
+
+    ZF_LOGI("Removed %d duplicated entries",
+            B->row_offsets[nrows] - nnz);
+
+    free(B->cols);
+    free(B->row_offsets);
+    B->cols = cols;
+    B->row_offsets = counts;
+
+    return EXIT_SUCCESS;
+}
+
+int coo_to_csr_par(matrix_pcoo_t *A, matrix_pcsr_t *B, bool sort_rows,
+                   int nthreads) {
+
+    if (!check_matrix_pcoo(A)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int *rows = A->rows;
+    int nnz = A->nnz;
+    int nrows = A->nrows;
+    int nblocks = max(1, min(nthreads, nnz / 65536));
+
+    auto *row_offsets = (int *) malloc((nrows + 1) * sizeof(int));
+    auto *cols = (int *) malloc(max(nnz, 1) * sizeof(int));
+    auto *hist = (int *) calloc((size_t) nblocks * nrows, sizeof(int));
+
+    if (row_offsets == 0 || cols == 0 || hist == 0) {
+        ZF_LOGF("Memory allocation failed!");
+        free(row_offsets);
+        free(cols);
+        free(hist);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Count the non-zero entries per row of each block of A.
+     */
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 0; b < nblocks; b++) {
+        int *h = hist + (size_t) b * nrows;
+        int end = (int) ((long long) nnz * (b + 1) / nblocks);
+        for (int n = (int) ((long long) nnz * b / nblocks); n < end; n++)
+            h[rows[n]]++;
+    }
+
+    histograms_to_offsets(hist, nblocks, nrows, row_offsets, nthreads);
+
+    /*
+     * Each block scatters its entries in the slots reserved to it, which
+     * keeps the order of the serial conversion.
+     */
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 0; b < nblocks; b++) {
+        int *h = hist + (size_t) b * nrows;
+        int end = (int) ((long long) nnz * (b + 1) / nblocks);
+        for (int n = (int) ((long long) nnz * b / nblocks); n < end; n++)
+            cols[h[rows[n]]++] = A->cols[n];
+    }
+
+    free(hist);
+
+    B->nrows = nrows;
+    B->ncols = A->ncols;
+    B->cols = cols;
+    B->row_offsets = row_offsets;
+
+    if (sort_rows && sort_dedup_rows(B, nthreads)) {
+        free_matrix_pcsr(B);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int transpose_par(matrix_pcsr_t *A, matrix_pcsr_t *B, int nthreads) {
+
+    if (!check_matrix_pcsr(A)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int nrows = A->nrows;
+    int ncols = A->ncols;
+    int nnz = A->row_offsets[A->nrows];
+    int nblocks = max(1, min(nthreads, nnz / 65536));
+
+    auto *row_offsets = (int *) malloc((ncols + 1) * sizeof(int));
+    auto *cols = (int *) malloc(max(nnz, 1) * sizeof(int));
+    auto *hist = (int *) calloc((size_t) nblocks * ncols, sizeof(int));
+    auto *first_row = (int *) malloc((nblocks + 1) * sizeof(int));
+
+    if (row_offsets == 0 || cols == 0 || hist == 0 || first_row == 0) {
+        ZF_LOGF("Memory allocation failed!");
+        free(row_offsets);
+        free(cols);
+        free(hist);
+        free(first_row);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Split the rows of A in blocks with about the same number of entries.
+     */
+    for (int b = 0; b <= nblocks; b++) {
+        int target = (int) ((long long) nnz * b / nblocks);
+        first_row[b] = (int) (std::lower_bound(A->row_offsets,
+                                               A->row_offsets + nrows,
+                                               target) -
+                              A->row_offsets);
+    }
+    first_row[nblocks] = nrows;
+
+    /*
+     * Count the non-zero entries per column of each block of A.
+     */
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 0; b < nblocks; b++) {
+        int *h = hist + (size_t) b * ncols;
+        for (int n = A->row_offsets[first_row[b]];
+             n < A->row_offsets[first_row[b + 1]]; n++)
+            h[A->cols[n]]++;
+    }
+
+    histograms_to_offsets(hist, nblocks, ncols, row_offsets, nthreads);
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int b = 0; b < nblocks; b++) {
+        int *h = hist + (size_t) b * ncols;
+        for (int n = first_row[b]; n < first_row[b + 1]; n++) {
+            for (int j_a = A->row_offsets[n]; j_a < A->row_offsets[n + 1];
+                 j_a++)
+                cols[h[A->cols[j_a]]++] = n;
+        }
+    }
+
+    free(hist);
+    free(first_row);
+
+    B->nrows = ncols;
+    B->ncols = nrows;
+    B->row_offsets = row_offsets;
+    B->cols = cols;
+
+    return EXIT_SUCCESS;
+}
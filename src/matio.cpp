@@ -260,8 +260,8 @@ int read_mm(FILE *f, int *nnz, const int *m, const int *n,
                 return EXIT_FAILURE;
             }
 
-            if (gp->has_self_loops && tmp_col != tmp_row) {
-                if (!gp->is_directed) {
+            if (gp->has_self_loops || tmp_col != tmp_row) {
+                if (!gp->is_directed && tmp_col != tmp_row) {
                     cols[i] = tmp_col;
                     rows[i] = tmp_row;
                     weights[i] = tmp_wgh;
@@ -350,7 +350,8 @@ int read_mm_real(FILE *f, matrix_rcoo_t *m_coo, gprops_t *gp) {
     }
 
     m_coo->nnz = nnz;
-    m_coo->nrows = n;
+    m_coo->nrows = m;
+    m_coo->ncols = n;
     m_coo->rows = rows;
     m_coo->cols = cols;
     m_coo->weights = weights;
@@ -391,7 +392,323 @@ int read_mm_pattern(FILE *f, matrix_pcoo_t *m_coo, gprops_t *gp) {
     return 0;
 }
 
-int read_matrix(const char *fname, matrix_pcoo_t *m_coo, gprops_t *gp) {
+/**
+ * @brief Lines of the body of a Matrix Market file parsed by one thread.
+ */
+typedef struct mm_chunk_t {
+    const char *begin;// first character of the first line of the chunk
+    const char *end;  // first character after the last line of the chunk
+    int *pairs;       // row and column index of each line
+    int nlines;       // number of lines with an entry
+    int capacity;     // number of pairs that fit in the buffer
+    int nkept;        // entries stored in the COO matrix
+    int rmax;
+    int cmax;
+    int error;
+} mm_chunk_t;
+
+/**
+ * @brief Parse a non-negative decimal integer, skipping blanks before it.
+ *
+ * @return the first character after the integer, or 0 if there is no
+ * integer or it does not fit into an int
+ */
+static inline const char *parse_index(const char *p, const char *end,
+                                      int *value) {
+
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+
+    const char *first = p;
+    long long v = 0;
+
+    /*
+     * Ten digits are enough for INT_MAX, more are surely out of range.
+     */
+    while (p < end && (unsigned) (*p - '0') < 10 && p - first < 11) {
+        v = v * 10 + (*p - '0');
+        p++;
+    }
+
+    if (p == first || v > INT_MAX ||
+        (p < end && (unsigned) (*p - '0') < 10))
+        return 0;
+
+    *value = (int) v;
+    return p;
+}
+
+/**
+ * @brief Parse the lines of a chunk into row and column index pairs.
+ */
+static void parse_mm_chunk(mm_chunk_t *c) {
+
+    const char *p = c->begin;
+    const char *end = c->end;
+
+    while (p < end) {
+        const char *eol = (const char *) memchr(p, '\n', end - p);
+        if (eol == 0)
+            eol = end;
+
+        const char *q = p;
+        while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r'))
+            q++;
+
+        /*
+         * Skip blank lines and comments.
+         */
+        if (q == eol || *q == '%') {
+            p = eol + 1;
+            continue;
+        }
+
+        int tmp_row, tmp_col;
+        q = parse_index(q, eol, &tmp_row);
+        if (q != 0)
+            q = parse_index(q, eol, &tmp_col);
+
+        if (q == 0 || (q < eol && *q != ' ' && *q != '\t' && *q != '\r')) {
+            c->error = 1;
+            return;
+        }
+
+        if (c->nlines == c->capacity) {
+            c->capacity = 2 * c->capacity + 1024;
+            auto *tmp = (int *) realloc(c->pairs,
+                                        2 * (size_t) c->capacity *
+                                        sizeof(int));
+            if (tmp == 0) {
+                c->error = 1;
+                return;
+            }
+            c->pairs = tmp;
+        }
+
+        c->pairs[2 * c->nlines] = tmp_row;
+        c->pairs[2 * c->nlines + 1] = tmp_col;
+        c->nlines++;
+
+        p = eol + 1;
+    }
+}
+
+/**
+ * @brief Count the entries of the first nlines lines of a chunk that are
+ * stored in the COO matrix.
+ */
+static int count_mm_entries(const int *pairs, int nlines, gprops_t *gp) {
+
+    int nkept = 0;
+
+    for (int k = 0; k < nlines; k++) {
+        int tmp_row = pairs[2 * k];
+        int tmp_col = pairs[2 * k + 1];
+
+        if (gp->has_self_loops || tmp_col != tmp_row)
+            nkept += (!gp->is_directed && tmp_col != tmp_row) ? 2 : 1;
+    }
+
+    return nkept;
+}
+
+int read_mm_pattern_par(const char *fname, matrix_pcoo_t *m_coo,
+                        gprops_t *gp, int nthreads) {
+
+    MM_typecode matcode;
+    int nnz, m, n;
+    double tstart = get_time();
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    /*
+     * The header is parsed by mmio, the body is mapped in memory.
+     */
+    FILE *f = fopen(fname, "r");
+    if (f == 0) {
+        ZF_LOGF("Could not open %s", fname);
+        return EXIT_FAILURE;
+    }
+
+    if (read_header(f, &matcode, &m, &n, &nnz)) {
+        close_stream(f);
+        return EXIT_FAILURE;
+    }
+
+    if (!mm_is_pattern(matcode)) {
+        ZF_LOGF("Only pattern matrices are supported");
+        close_stream(f);
+        return EXIT_FAILURE;
+    }
+
+    long body_offset = ftell(f);
+    struct stat st {};
+
+    if (body_offset < 0 || fstat(fileno(f), &st) != 0) {
+        ZF_LOGF("Could not get size of %s", fname);
+        close_stream(f);
+        return EXIT_FAILURE;
+    }
+
+    size_t file_len = st.st_size;
+    void *map = mmap(0, file_len, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+    close_stream(f);
+
+    if (map == MAP_FAILED) {
+        ZF_LOGF("Could not map %s", fname);
+        return EXIT_FAILURE;
+    }
+    madvise(map, file_len, MADV_SEQUENTIAL);
+
+    gp->is_directed = !mm_is_symmetric(matcode);
+
+    /*
+     * Split the body in chunks starting at the beginning of a line.
+     */
+    const char *body = (const char *) map + body_offset;
+    const char *body_end = (const char *) map + file_len;
+    size_t body_len = body_end - body;
+    int nchunks = max(1, min(4 * nthreads, (int) (body_len >> 12) + 1));
+
+    auto *chunks = (mm_chunk_t *) calloc(nchunks, sizeof(mm_chunk_t));
+    assert(chunks);
+
+    for (int k = 0; k < nchunks; k++) {
+        const char *p = body + body_len * k / nchunks;
+        if (k > 0) {
+            p = (const char *) memchr(p - 1, '\n', body_end - p + 1);
+            p = (p == 0) ? body_end : p + 1;
+        }
+        if (k > 0 && p < chunks[k - 1].begin)
+            p = chunks[k - 1].begin;
+        chunks[k].begin = p;
+        if (k > 0)
+            chunks[k - 1].end = chunks[k].begin;
+    }
+    chunks[nchunks - 1].end = body_end;
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (int k = 0; k < nchunks; k++) {
+        mm_chunk_t *c = &chunks[k];
+        c->capacity = (int) ((double) nnz * (c->end - c->begin) /
+                             (double) (body_len + 1)) + 16;
+        c->pairs = (int *) malloc(2 * (size_t) c->capacity * sizeof(int));
+        c->error = (c->pairs == 0);
+        if (!c->error)
+            parse_mm_chunk(c);
+    }
+
+    /*
+     * Only the first nnz lines are read, as done by read_mm.
+     */
+    int nlines = 0, err = 0;
+    for (int k = 0; k < nchunks; k++) {
+        err |= chunks[k].error;
+        chunks[k].nlines = min(chunks[k].nlines, nnz - nlines);
+        nlines += chunks[k].nlines;
+    }
+
+    if (err || nlines < nnz) {
+        ZF_LOGF("Malformed or truncated entries in %s", fname);
+        for (int k = 0; k < nchunks; k++)
+            free(chunks[k].pairs);
+        free(chunks);
+        munmap(map, file_len);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * Indices are one-based, as in read_mm, unless the first entry has a
+     * zero index. There is at least one entry, since read_header rejects
+     * empty matrices.
+     */
+    bool one_based = !(chunks[0].pairs[0] == 0 || chunks[0].pairs[1] == 0);
+    size_t size = mm_is_symmetric(matcode) ? 2 * nnz + 1 : nnz + 1;
+    auto *rows = (int *) malloc(size * sizeof(int));
+    auto *cols = (int *) malloc(size * sizeof(int));
+    auto *offsets = (int *) malloc((nchunks + 1) * sizeof(int));
+    assert(rows);
+    assert(cols);
+    assert(offsets);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (int k = 0; k < nchunks; k++)
+        chunks[k].nkept = count_mm_entries(chunks[k].pairs, chunks[k].nlines,
+                                           gp);
+
+    offsets[0] = 0;
+    for (int k = 0; k < nchunks; k++)
+        offsets[k + 1] = offsets[k] + chunks[k].nkept;
+
+    /*
+     * Merge the slices of the threads, keeping the order of the file.
+     */
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (int k = 0; k < nchunks; k++) {
+        mm_chunk_t *c = &chunks[k];
+        int i = offsets[k];
+        int shift = one_based ? 1 : 0;
+
+        c->rmax = 0;
+        c->cmax = 0;
+        for (int l = 0; l < c->nlines; l++) {
+            int tmp_row = c->pairs[2 * l];
+            int tmp_col = c->pairs[2 * l + 1];
+
+            if (!gp->has_self_loops && tmp_col == tmp_row)
+                continue;
+
+            c->rmax = max(tmp_row, c->rmax);
+            c->cmax = max(tmp_col, c->cmax);
+            rows[i] = tmp_row - shift;
+            cols[i] = tmp_col - shift;
+            i++;
+
+            if (!gp->is_directed && tmp_col != tmp_row) {
+                c->rmax = max(tmp_col, c->rmax);
+                c->cmax = max(tmp_row, c->cmax);
+                rows[i] = tmp_col - shift;
+                cols[i] = tmp_row - shift;
+                i++;
+            }
+        }
+    }
+
+    int rmax = 0, cmax = 0;
+    for (int k = 0; k < nchunks; k++) {
+        rmax = max(rmax, chunks[k].rmax);
+        cmax = max(cmax, chunks[k].cmax);
+        free(chunks[k].pairs);
+    }
+    nnz = offsets[nchunks];
+    free(offsets);
+    free(chunks);
+    munmap(map, file_len);
+
+    if (one_based ? (rmax > m || cmax > n) : (rmax >= m || cmax >= n)) {
+        ZF_LOGF("Indices out of range");
+        free(rows);
+        free(cols);
+        return EXIT_FAILURE;
+    }
+
+    m_coo->nnz = nnz;
+    m_coo->nrows = m;
+    m_coo->ncols = n;
+    m_coo->rows = rows;
+    m_coo->cols = cols;
+
+    double elapsed = get_time() - tstart;
+    ZF_LOGI("Parsed %.1f MB of %s in %g s (%.1f MB/s) with %d threads",
+            file_len / 1e6, fname, elapsed,
+            (elapsed > 0) ? file_len / 1e6 / elapsed : 0.0, nthreads);
+
+    return EXIT_SUCCESS;
+}
+
+int read_matrix(const char *fname, matrix_pcoo_t *m_coo, gprops_t *gp,
+                int nthreads) {
 
     if (has_extension(fname, "mtx", strlen(fname)) ||
         has_extension(fname, "mm", strlen(fname))) {
@@ -399,28 +716,41 @@ int read_matrix(const char *fname, matrix_pcoo_t *m_coo, gprops_t *gp) {
         if (gp->is_weighted) {
             ZF_LOGF("Weighted graph is not supported");
             return EXIT_FAILURE;
-        } else {
-            FILE *f;
-            f = fopen(fname, "r");
+        } else if (read_mm_pattern_par(fname, m_coo, gp, nthreads)) {
+            ZF_LOGF("Error reading matrix");
+            return EXIT_FAILURE;
+        }
 
-            if (f == 0) {
-                ZF_LOGF("Could not open %s", fname);
-                return EXIT_FAILURE;
-            }
+    } else {
+        ZF_LOGF("Unsupported file type");
+        return EXIT_FAILURE;
+    }
 
-            if (read_mm_pattern(f, m_coo, gp)) {
-                ZF_LOGF("Error reading matrix");
-                return EXIT_FAILURE;
-            }
+    return EXIT_SUCCESS;
+}
 
-            close_stream(f);
-        }
+int read_matrix_real(const char *fname, matrix_rcoo_t *m_coo, gprops_t *gp) {
 
-    } else {
+    if (!has_extension(fname, "mtx", strlen(fname)) &&
+        !has_extension(fname, "mm", strlen(fname))) {
         ZF_LOGF("Unsupported file type");
         return EXIT_FAILURE;
     }
 
+    FILE *f = fopen(fname, "r");
+    if (f == 0) {
+        ZF_LOGF("Could not open %s", fname);
+        return EXIT_FAILURE;
+    }
+
+    int err = read_mm_real(f, m_coo, gp);
+    close_stream(f);
+
+    if (err) {
+        ZF_LOGF("Error reading matrix");
+        return EXIT_FAILURE;
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -492,3 +822,228 @@ int write_mm_real(FILE *f, matrix_rcoo_t *m_coo, bool directed) {
 
     return EXIT_SUCCESS;
 }
+
+char *get_csr_cache_fname(const char *fname) {
+
+    size_t length = strlen(fname) + strlen(CSR_CACHE_EXTENSION) + 1;
+    auto *cname = (char *) malloc(length * sizeof(char));
+
+    if (cname == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return 0;
+    }
+
+    snprintf(cname, length, "%s%s", fname, CSR_CACHE_EXTENSION);
+    return cname;
+}
+
+/**
+ * @brief Fill the fields of the header that identify the source file.
+ */
+static int get_source_stamp(const char *fname, csr_cache_header_t *h) {
+
+    struct stat st {};
+
+    if (stat(fname, &st) != 0) {
+        ZF_LOGE("Could not stat %s", fname);
+        return EXIT_FAILURE;
+    }
+
+    h->src_size = (long long) st.st_size;
+    h->src_mtime_sec = (long long) st.st_mtim.tv_sec;
+    h->src_mtime_nsec = (long long) st.st_mtim.tv_nsec;
+
+    return EXIT_SUCCESS;
+}
+
+int write_csr_cache(const char *cname,
+                    const char *fname,
+                    matrix_pcsr_t *g,
+                    gprops_t *gp) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    csr_cache_header_t h;
+    memset(&h, 0, sizeof(h));
+    strncpy(h.magic, CSR_CACHE_MAGIC, sizeof(h.magic));
+    h.version = CSR_CACHE_VERSION;
+    h.byte_order = 0x01020304;
+    h.gp = *gp;
+    h.nrows = g->nrows;
+    h.ncols = g->ncols;
+    h.nnz = g->row_offsets[g->nrows];
+
+    if (get_source_stamp(fname, &h))
+        return EXIT_FAILURE;
+
+    size_t length = strlen(cname) + 5;
+    auto *tmp_name = (char *) malloc(length * sizeof(char));
+    if (tmp_name == 0) {
+        ZF_LOGE("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+    snprintf(tmp_name, length, "%s.tmp", cname);
+
+    FILE *f = fopen(tmp_name, "wb");
+    if (f == 0) {
+        ZF_LOGW("Could not create cache file %s", tmp_name);
+        free(tmp_name);
+        return EXIT_FAILURE;
+    }
+
+    bool failed =
+            fwrite(&h, sizeof(h), 1, f) != 1 ||
+            fwrite(g->row_offsets, sizeof(int), g->nrows + 1, f) !=
+                    (size_t) g->nrows + 1 ||
+            fwrite(g->cols, sizeof(int), h.nnz, f) != (size_t) h.nnz;
+
+    if (close_stream(f) != 0 || failed ||
+        rename(tmp_name, cname) != 0) {
+        ZF_LOGW("Could not write cache file %s", cname);
+        remove(tmp_name);
+        free(tmp_name);
+        return EXIT_FAILURE;
+    }
+
+    free(tmp_name);
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Map a cache file in memory and validate it against the Matrix
+ * Market file it was created from.
+ */
+static int map_csr_cache(const char *cname,
+                         const char *fname,
+                         gprops_t *gp,
+                         void **mapping,
+                         size_t *mapping_len) {
+
+    csr_cache_header_t src;
+    if (get_source_stamp(fname, &src))
+        return EXIT_FAILURE;
+
+    int fd = open(cname, O_RDONLY);
+    if (fd < 0) {
+        ZF_LOGI("No cache file %s", cname);
+        return EXIT_FAILURE;
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 ||
+        (size_t) st.st_size < sizeof(csr_cache_header_t)) {
+        ZF_LOGW("Invalid cache file %s", cname);
+        close(fd);
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * The mapping stays valid after the descriptor is closed.
+     */
+    void *map = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED) {
+        ZF_LOGW("Could not map cache file %s", cname);
+        return EXIT_FAILURE;
+    }
+
+    auto *h = (const csr_cache_header_t *) map;
+    size_t expected_size = sizeof(csr_cache_header_t) +
+                           ((size_t) h->nrows + 1 + h->nnz) * sizeof(int);
+
+    if (strncmp(h->magic, CSR_CACHE_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != CSR_CACHE_VERSION || h->byte_order != 0x01020304 ||
+        h->nrows < 0 || h->nnz < 0 ||
+        (size_t) st.st_size != expected_size) {
+        ZF_LOGW("Invalid or outdated cache file %s", cname);
+        munmap(map, st.st_size);
+        return EXIT_FAILURE;
+    }
+
+    if (h->src_size != src.src_size ||
+        h->src_mtime_sec != src.src_mtime_sec ||
+        h->src_mtime_nsec != src.src_mtime_nsec ||
+        h->gp.has_self_loops != gp->has_self_loops) {
+        ZF_LOGI("Stale cache file %s", cname);
+        munmap(map, st.st_size);
+        return EXIT_FAILURE;
+    }
+
+    *gp = h->gp;
+    *mapping = map;
+    *mapping_len = st.st_size;
+
+    return EXIT_SUCCESS;
+}
+
+int open_csr_cache(const char *cname,
+                   const char *fname,
+                   matrix_pcsr_view_t *g,
+                   gprops_t *gp) {
+
+    void *map;
+    size_t map_len;
+
+    if (map_csr_cache(cname, fname, gp, &map, &map_len))
+        return EXIT_FAILURE;
+
+    auto *h = (const csr_cache_header_t *) map;
+
+    g->nrows = h->nrows;
+    g->ncols = h->ncols;
+    g->row_offsets = (int *) (h + 1);
+    g->cols = g->row_offsets + h->nrows + 1;
+    g->mapping = map;
+    g->mapping_len = map_len;
+
+    return EXIT_SUCCESS;
+}
+
+void close_csr_cache(matrix_pcsr_view_t *g) {
+
+    if (g->mapping != 0)
+        munmap(g->mapping, g->mapping_len);
+
+    g->mapping = 0;
+    g->mapping_len = 0;
+    g->row_offsets = 0;
+    g->cols = 0;
+    g->nrows = -1;
+    g->ncols = -1;
+}
+
+int read_csr_cache(const char *cname,
+                   const char *fname,
+                   matrix_pcsr_t *g,
+                   gprops_t *gp) {
+
+    matrix_pcsr_view_t view;
+
+    if (open_csr_cache(cname, fname, &view, gp))
+        return EXIT_FAILURE;
+
+    int nnz = view.row_offsets[view.nrows];
+
+    g->nrows = view.nrows;
+    g->ncols = view.ncols;
+    g->row_offsets = (int *) malloc((view.nrows + 1) * sizeof(int));
+    g->cols = (int *) malloc(nnz * sizeof(int));
+
+    if (g->row_offsets == 0 || g->cols == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(g->row_offsets);
+        free(g->cols);
+        close_csr_cache(&view);
+        return EXIT_FAILURE;
+    }
+
+    memcpy(g->row_offsets, view.row_offsets, (view.nrows + 1) * sizeof(int));
+    memcpy(g->cols, view.cols, nnz * sizeof(int));
+
+    close_csr_cache(&view);
+    return EXIT_SUCCESS;
+}
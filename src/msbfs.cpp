@@ -0,0 +1,295 @@
+/****************************************************************************
+ * @file msbfs.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Bit-parallel multi-source BFS on the CPU and its applications to
+ * closeness centrality and eccentricity.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "msbfs.h"
+
+int init_msbfs_workspace(msbfs_workspace_t *ws, int nvertices) {
+
+    size_t size = (size_t) nvertices * MSBFS_WORDS;
+
+    ws->nvertices = nvertices;
+    ws->seen = (lane_t *) calloc(size, sizeof(lane_t));
+    ws->visit = (lane_t *) calloc(size, sizeof(lane_t));
+    ws->visit_next = (lane_t *) calloc(size, sizeof(lane_t));
+
+    if (ws->seen == 0 || ws->visit == 0 || ws->visit_next == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_msbfs_workspace(ws);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void free_msbfs_workspace(msbfs_workspace_t *ws) {
+    free(ws->seen);
+    free(ws->visit);
+    free(ws->visit_next);
+    ws->seen = 0;
+    ws->visit = 0;
+    ws->visit_next = 0;
+    ws->nvertices = 0;
+}
+
+void msbfs_visit(matrix_pcsr_t *g,
+                 const int *sources,
+                 int nsources,
+                 msbfs_workspace_t *ws) {
+
+    int nvertices = g->nrows;
+    const int *row_offsets = g->row_offsets;
+    const int *cols = g->cols;
+    lane_t *seen = ws->seen;
+    lane_t *visit = ws->visit;
+    lane_t *visit_next = ws->visit_next;
+
+    for (int i = 0; i < MSBFS_LANES; i++) {
+        ws->dist_sum[i] = 0;
+        ws->inv_dist_sum[i] = 0.0;
+        ws->nreached[i] = 0;
+        ws->ecc[i] = 0;
+    }
+
+    for (int i = 0; i < nsources; i++) {
+        size_t idx = (size_t) sources[i] * MSBFS_WORDS + (i >> 6);
+        seen[idx] |= 1ULL << (i & 63);
+        visit[idx] |= 1ULL << (i & 63);
+        ws->nreached[i] = 1;
+    }
+
+    bool active = true;
+
+    for (int depth = 1; active; depth++) {
+
+        active = false;
+
+        /*
+         * Each vertex in the frontier of at least one source pushes the set of
+         * those sources to its neighbours.
+         */
+        for (int v = 0; v < nvertices; v++) {
+            const lane_t *v_visit = visit + (size_t) v * MSBFS_WORDS;
+
+            lane_t any = 0;
+            for (int j = 0; j < MSBFS_WORDS; j++)
+                any |= v_visit[j];
+
+            if (any == 0)
+                continue;
+
+            for (int k = row_offsets[v]; k < row_offsets[v + 1]; k++) {
+                lane_t *w_next = visit_next + (size_t) cols[k] * MSBFS_WORDS;
+                for (int j = 0; j < MSBFS_WORDS; j++)
+                    w_next[j] |= v_visit[j];
+            }
+        }
+
+        /*
+         * Keep only the sources that had not already seen the vertex. They
+         * make up the frontier of the next level.
+         */
+        lane_t found[MSBFS_WORDS] = {0};
+        double inv_depth = 1.0 / depth;
+
+        for (int v = 0; v < nvertices; v++) {
+            size_t base = (size_t) v * MSBFS_WORDS;
+
+            for (int j = 0; j < MSBFS_WORDS; j++) {
+                lane_t discovered = visit_next[base + j] & ~seen[base + j];
+                visit_next[base + j] = 0;
+                seen[base + j] |= discovered;
+                visit[base + j] = discovered;
+                found[j] |= discovered;
+
+                while (discovered != 0) {
+                    int lane = (j << 6) + __builtin_ctzll(discovered);
+                    ws->dist_sum[lane] += depth;
+                    ws->inv_dist_sum[lane] += inv_depth;
+                    ws->nreached[lane]++;
+                    discovered &= discovered - 1;
+                }
+            }
+        }
+
+        for (int j = 0; j < MSBFS_WORDS; j++) {
+            lane_t lanes = found[j];
+            active |= (lanes != 0);
+
+            while (lanes != 0) {
+                ws->ecc[(j << 6) + __builtin_ctzll(lanes)] = depth;
+                lanes &= lanes - 1;
+            }
+        }
+    }
+
+    /*
+     * Vertices are left seen by the sources of this batch.
+     */
+    memset(seen, 0, (size_t) nvertices * MSBFS_WORDS * sizeof(lane_t));
+}
+
+/**
+ * @brief Runs a multi-source BFS for each batch of sources and stores the
+ * closeness of the given kind or the eccentricity of each source. Every
+ * vertex is a source if sources is 0.
+ */
+static int msbfs_all_sources(matrix_pcsr_t *g,
+                             const int *sources,
+                             int nsources_all,
+                             ClosenessKind kind,
+                             double *cl,
+                             int *eccentricity,
+                             int nthreads) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+
+    if (sources == 0)
+        nsources_all = nvertices;
+
+    int nbatches = (nsources_all + MSBFS_LANES - 1) / MSBFS_LANES;
+    int err = EXIT_SUCCESS;
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        msbfs_workspace_t ws;
+        int t_err = init_msbfs_workspace(&ws, nvertices);
+
+#pragma omp for schedule(dynamic, 1)
+        for (int b = 0; b < nbatches; b++) {
+
+            if (t_err)
+                continue;
+
+            int first = b * MSBFS_LANES;
+            int nsources = min(MSBFS_LANES, nsources_all - first);
+            int batch[MSBFS_LANES];
+
+            for (int i = 0; i < nsources; i++)
+                batch[i] = (sources != 0) ? sources[first + i] : first + i;
+
+            msbfs_visit(g, batch, nsources, &ws);
+
+            for (int i = 0; i < nsources; i++) {
+                int unreached = nvertices - ws.nreached[i];
+
+                if (cl != 0 && kind == classic_closeness) {
+                    /*
+                     * Unreachable vertices keep an infinite distance as in
+                     * compute_cl_cpu.
+                     */
+                    unsigned long long tot_d =
+                            ws.dist_sum[i] +
+                            (unsigned long long) unreached * INT_MAX;
+                    cl[batch[i]] =
+                            ((double) nvertices - 1.0) / (double) tot_d;
+                } else if (cl != 0 && kind == harmonic_closeness) {
+                    cl[batch[i]] = (nvertices > 1)
+                                   ? ws.inv_dist_sum[i] / (nvertices - 1.0)
+                                   : 0.0;
+                } else if (cl != 0) {
+                    double reached = ws.nreached[i] - 1.0;
+                    cl[batch[i]] = (reached > 0)
+                                   ? reached / (nvertices - 1.0) * reached /
+                                     (double) ws.dist_sum[i]
+                                   : 0.0;
+                }
+
+                if (eccentricity != 0) {
+                    eccentricity[batch[i]] =
+                            (unreached > 0) ? INT_MAX : ws.ecc[i];
+                }
+            }
+        }
+
+        if (t_err) {
+#pragma omp atomic write
+            err = EXIT_FAILURE;
+        }
+
+        free_msbfs_workspace(&ws);
+    }
+
+    return err;
+}
+
+int compute_cl_cpu_msbfs(matrix_pcsr_t *g, double *cl, int nthreads) {
+    return msbfs_all_sources(g, 0, 0, classic_closeness, cl, 0, nthreads);
+}
+
+int compute_closeness_cpu_msbfs(matrix_pcsr_t *g,
+                                ClosenessKind kind,
+                                double *cl,
+                                int nthreads) {
+    return msbfs_all_sources(g, 0, 0, kind, cl, 0, nthreads);
+}
+
+const char *get_closeness_name(ClosenessKind kind) {
+
+    switch (kind) {
+        case classic_closeness:
+            return "classic";
+        case harmonic_closeness:
+            return "harmonic";
+        case wasserman_faust_closeness:
+            return "wf";
+        default:
+            return 0;
+    }
+}
+
+int compute_cl_cpu_msbfs_sources(matrix_pcsr_t *g,
+                                 const int *sources,
+                                 int nsources,
+                                 double *cl,
+                                 int nthreads) {
+    return msbfs_all_sources(g, sources, nsources, classic_closeness, cl, 0,
+                             nthreads);
+}
+
+int get_vertices_eccentricity_msbfs(matrix_pcsr_t *g,
+                                    int *eccentricity,
+                                    int nthreads) {
+    return msbfs_all_sources(g, 0, 0, classic_closeness, 0, eccentricity,
+                             nthreads);
+}
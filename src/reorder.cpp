@@ -0,0 +1,342 @@
+/****************************************************************************
+ * @file reorder.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Implementation of the vertex reordering strategies.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "reorder.h"
+
+/**
+ * @brief Reverse Cuthill-McKee ordering.
+ */
+static void get_rcm_order(matrix_pcsr_t *g, int *order) {
+
+    int nvertices = g->nrows;
+    std::vector<int> by_degree(nvertices), neighbors;
+    std::vector<bool> visited(nvertices, false);
+
+    for (int v = 0; v < nvertices; v++)
+        by_degree[v] = v;
+
+    auto degree = [g](int v) {
+        return g->row_offsets[v + 1] - g->row_offsets[v];
+    };
+    auto by_increasing_degree = [&degree](int u, int v) {
+        return degree(u) < degree(v) || (degree(u) == degree(v) && u < v);
+    };
+    std::sort(by_degree.begin(), by_degree.end(), by_increasing_degree);
+
+    int tail = 0;
+    for (int k = 0; k < nvertices; k++) {
+        int s = by_degree[k];
+        if (visited[s])
+            continue;
+
+        /*
+         * Each cc is visited from its lowest degree vertex, which tends to
+         * be far from the center.
+         */
+        int head = tail;
+        order[tail++] = s;
+        visited[s] = true;
+
+        while (head < tail) {
+            int u = order[head++];
+
+            neighbors.clear();
+            for (int j = g->row_offsets[u]; j < g->row_offsets[u + 1]; j++) {
+                int w = g->cols[j];
+                if (!visited[w]) {
+                    visited[w] = true;
+                    neighbors.push_back(w);
+                }
+            }
+
+            std::sort(neighbors.begin(), neighbors.end(),
+                      by_increasing_degree);
+            for (int w : neighbors)
+                order[tail++] = w;
+        }
+    }
+
+    std::reverse(order, order + nvertices);
+}
+
+/**
+ * @brief Vertices by decreasing degree, ties broken by id.
+ */
+static void get_degree_order(matrix_pcsr_t *g, int *order) {
+
+    for (int v = 0; v < g->nrows; v++)
+        order[v] = v;
+
+    std::stable_sort(order, order + g->nrows, [g](int u, int v) {
+        return g->row_offsets[u + 1] - g->row_offsets[u] >
+               g->row_offsets[v + 1] - g->row_offsets[v];
+    });
+}
+
+/**
+ * @brief Add delta to the score of the unplaced neighbors and siblings of
+ * v, pushing the updated scores in the queue.
+ */
+static void update_gorder_scores(matrix_pcsr_t *g, int v, int delta,
+                                 std::vector<int> &score,
+                                 const std::vector<bool> &placed,
+                                 std::priority_queue<std::pair<int, int>> &Q) {
+
+    for (int j = g->row_offsets[v]; j < g->row_offsets[v + 1]; j++) {
+        int u = g->cols[j];
+
+        if (!placed[u]) {
+            score[u] += delta;
+            if (delta > 0)
+                Q.push(std::make_pair(score[u], -u));
+        }
+
+        if (g->row_offsets[u + 1] - g->row_offsets[u] > GORDER_MAX_HUB_DEGREE)
+            continue;
+
+        for (int k = g->row_offsets[u]; k < g->row_offsets[u + 1]; k++) {
+            int w = g->cols[k];
+            if (!placed[w] && w != v) {
+                score[w] += delta;
+                if (delta > 0)
+                    Q.push(std::make_pair(score[w], -w));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Greedy window-based ordering in the style of Gorder.
+ *
+ * Scores are kept in a lazy max-heap: increased scores are pushed at once,
+ * while decreased ones are pushed only when the stale entry is popped.
+ */
+static void get_locality_order(matrix_pcsr_t *g, int *order) {
+
+    int nvertices = g->nrows;
+    std::vector<int> score(nvertices, 0), by_degree(nvertices);
+    std::vector<bool> placed(nvertices, false);
+    std::priority_queue<std::pair<int, int>> Q;
+
+    get_degree_order(g, by_degree.data());
+
+    for (int i = 0, next_hub = 0; i < nvertices; i++) {
+        int v = -1;
+
+        while (!Q.empty() && v == -1) {
+            int s = Q.top().first;
+            int u = -Q.top().second;
+            Q.pop();
+
+            if (placed[u] || s <= 0)
+                continue;
+            if (s != score[u]) {
+                /*
+                 * A lower stale score means that the current one is still
+                 * in the queue.
+                 */
+                if (s > score[u] && score[u] > 0)
+                    Q.push(std::make_pair(score[u], -u));
+                continue;
+            }
+            v = u;
+        }
+
+        /*
+         * Start from the highest degree vertex left when the window has no
+         * unplaced neighbors or siblings.
+         */
+        if (v == -1) {
+            while (placed[by_degree[next_hub]])
+                next_hub++;
+            v = by_degree[next_hub];
+        }
+
+        order[i] = v;
+        placed[v] = true;
+        update_gorder_scores(g, v, 1, score, placed, Q);
+
+        if (i >= GORDER_WINDOW)
+            update_gorder_scores(g, order[i - GORDER_WINDOW], -1, score,
+                                 placed, Q);
+    }
+}
+
+int get_vertex_order(matrix_pcsr_t *g, ReorderStrategy strategy, int *new_id) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    auto *order = (int *) malloc(g->nrows * sizeof(int));
+    if (order == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+    switch (strategy) {
+        case no_reorder:
+            for (int v = 0; v < g->nrows; v++)
+                order[v] = v;
+            break;
+        case rcm_reorder:
+            get_rcm_order(g, order);
+            break;
+        case degree_reorder:
+            get_degree_order(g, order);
+            break;
+        case locality_reorder:
+            get_locality_order(g, order);
+            break;
+        default:
+            ZF_LOGE("Invalid reordering strategy");
+            free(order);
+            return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < g->nrows; i++)
+        new_id[order[i]] = i;
+
+    free(order);
+    return EXIT_SUCCESS;
+}
+
+int permute_graph(matrix_pcsr_t *g, const int *new_id, matrix_pcsr_t *h,
+                  int nthreads) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGE("The matrix is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    if (nthreads <= 0)
+        nthreads = omp_get_max_threads();
+
+    int nvertices = g->nrows;
+    int nnz = g->row_offsets[nvertices];
+    auto *old_id = (int *) malloc(nvertices * sizeof(int));
+    auto *row_offsets = (int *) malloc((nvertices + 1) * sizeof(int));
+    auto *cols = (int *) malloc(max(nnz, 1) * sizeof(int));
+
+    if (old_id == 0 || row_offsets == 0 || cols == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(old_id);
+        free(row_offsets);
+        free(cols);
+        return EXIT_FAILURE;
+    }
+
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+    for (int v = 0; v < nvertices; v++) {
+        old_id[new_id[v]] = v;
+        row_offsets[new_id[v]] = g->row_offsets[v + 1] - g->row_offsets[v];
+    }
+
+    exclusive_scan_par(row_offsets, nvertices, nthreads);
+    row_offsets[nvertices] = nnz;
+
+#pragma omp parallel for schedule(dynamic, 1024) num_threads(nthreads)
+    for (int i = 0; i < nvertices; i++) {
+        int v = old_id[i];
+        int *row = cols + row_offsets[i];
+
+        for (int j = g->row_offsets[v]; j < g->row_offsets[v + 1]; j++)
+            *row++ = new_id[g->cols[j]];
+
+        std::sort(cols + row_offsets[i], cols + row_offsets[i + 1]);
+    }
+
+    free(old_id);
+
+    h->nrows = nvertices;
+    h->ncols = g->ncols;
+    h->row_offsets = row_offsets;
+    h->cols = cols;
+
+    return EXIT_SUCCESS;
+}
+
+int unpermute_scores(double *scores, const int *new_id, int nvertices) {
+
+    auto *tmp = (double *) malloc(nvertices * sizeof(double));
+    if (tmp == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+    for (int v = 0; v < nvertices; v++)
+        tmp[v] = scores[new_id[v]];
+
+    memcpy(scores, tmp, nvertices * sizeof(double));
+    free(tmp);
+
+    return EXIT_SUCCESS;
+}
+
+int unpermute_ids(int *ids, int nids, const int *new_id, int nvertices) {
+
+    auto *old_id = (int *) malloc(nvertices * sizeof(int));
+    if (old_id == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+    for (int v = 0; v < nvertices; v++)
+        old_id[new_id[v]] = v;
+
+    for (int i = 0; i < nids; i++)
+        ids[i] = old_id[ids[i]];
+
+    free(old_id);
+
+    return EXIT_SUCCESS;
+}
+
+const char *get_reorder_name(ReorderStrategy strategy) {
+
+    switch (strategy) {
+        case no_reorder:
+            return "none";
+        case rcm_reorder:
+            return "rcm";
+        case degree_reorder:
+            return "degree";
+        case locality_reorder:
+            return "locality";
+        default:
+            return 0;
+    }
+}
@@ -32,8 +32,15 @@
  ****************************************************************************/
 
 #include "bc.h"
+#include "bc_approx.h"
+#include "bc_batch.h"
+#include "bc_spmm.h"
+#include "bc_bcc.h"
+#include "bc_fold.h"
 #include "bc_ep_kernel.cuh"
 #include "bc_statistics.h"
+#include "bc_vp_cpu.h"
+#include "bc_weighted.h"
 #include "bc_vp_kernel.cuh"
 #include "bc_we_kernel.cuh"
 #include "bc_we_kernel_nopitch.cuh"
@@ -41,8 +48,199 @@
 #include "cl_kernels.cuh"
 #include "degree.h"
 #include "matio.h"
+#include "msbfs.h"
+#include "reorder.h"
+#include "twins.h"
 #include <cli.cuh>
 
+/**
+ * @brief Computes the scores of a weighted graph on the CPU, since the GPU
+ * kernels visit the graph by levels.
+ */
+static int run_weighted(params_t *params, gprops_t *gp) {
+
+    matrix_rcoo_t m_coo;
+    matrix_rcsr_t g;
+    stats_t stats;
+
+    if (read_matrix_real(params->input_file, &m_coo, gp) ||
+        rcoo_to_rcsr(&m_coo, &g)) {
+        ZF_LOGF("Could not read matrix %s", params->input_file);
+        return EXIT_FAILURE;
+    }
+    free_matrix_rcoo(&m_coo);
+
+    auto *degree = (int *) malloc(g.nrows * sizeof(int));
+    auto *bc = (double *) malloc(g.nrows * sizeof(double));
+    auto *cl = (double *) malloc(g.nrows * sizeof(double));
+
+    if (degree == 0 || bc == 0 || cl == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+    compute_degrees_undirected(&g, degree);
+
+    if (!params->quiet) {
+        print_run_config(params);
+        print_graph_properties(gp);
+        ZF_LOGW("Weighted graphs are processed on the CPU, the technique "
+                "is ignored");
+    }
+
+    double tstart = get_time();
+    if (compute_dijkstra_bc_cpu(&g, bc, gp->is_directed, params->nthreads,
+                                &stats) ||
+        compute_dijkstra_cl_cpu(&g, cl, params->nthreads)) {
+        ZF_LOGF("Could not compute the weighted scores");
+        return EXIT_FAILURE;
+    }
+    stats.total_time = get_time() - tstart;
+
+    if (params->dump_scores != 0)
+        dump_scores(g.nrows, degree, bc, cl, params->dump_scores);
+
+    if (params->dump_stats != 0) {
+        append_stats(&stats, params->dump_stats, params->technique);
+    } else if (!params->quiet) {
+        print_stats(&stats);
+    }
+
+    free(degree);
+    free(bc);
+    free(cl);
+    free_matrix_rcsr(&g);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Computes the scores of a directed graph on the CPU, since the GPU
+ * kernels follow each edge in both directions. The arcs are kept as they are
+ * stored and the largest weakly or strongly connected component is
+ * extracted.
+ */
+static int run_directed(params_t *params, gprops_t *gp) {
+
+    matrix_pcoo_t m_coo;
+    matrix_pcsr_t m_csr, g;
+    components_t ccs;
+    stats_t stats;
+
+    if (read_matrix(params->input_file, &m_coo, gp, params->nthreads) ||
+        coo_to_csr_par(&m_coo, &m_csr, false, params->nthreads)) {
+        ZF_LOGF("Could not read matrix %s", params->input_file);
+        return EXIT_FAILURE;
+    }
+    free_matrix_pcoo(&m_coo);
+
+    double tstart = get_time();
+    int err = params->use_scc ? get_scc(&m_csr, &ccs)
+                              : get_wcc(&m_csr, &ccs, params->nthreads);
+    if (err) {
+        ZF_LOGF("Could not compute the connected components");
+        return EXIT_FAILURE;
+    }
+
+    gp->is_connected = (ccs.cc_count == 1);
+    if (!gp->is_connected) {
+        get_largest_cc(&m_csr, &g, &ccs, params->nthreads);
+        free_matrix_pcsr(&m_csr);
+    } else {
+        g = m_csr;
+    }
+    free_ccs(&ccs);
+    ZF_LOGI("Component extraction executed in: %g s", get_time() - tstart);
+
+    auto *in_degree = (int *) malloc(g.nrows * sizeof(int));
+    auto *out_degree = (int *) malloc(g.nrows * sizeof(int));
+    auto *rows = (int *) malloc(g.row_offsets[g.nrows] * sizeof(int));
+    auto *bc = (double *) malloc(g.nrows * sizeof(double));
+    auto *cl = (double *) malloc(g.nrows * sizeof(double));
+
+    if (in_degree == 0 || out_degree == 0 || rows == 0 || bc == 0 ||
+        cl == 0) {
+        ZF_LOGF("Could not allocate memory");
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * The arcs are seen in COO format to count the in-degrees.
+     */
+    matrix_pcoo_t arcs;
+    expand_row_pointer(g.nrows, g.row_offsets, rows);
+    arcs.nrows = g.nrows;
+    arcs.ncols = g.ncols;
+    arcs.nnz = g.row_offsets[g.nrows];
+    arcs.rows = rows;
+    arcs.cols = g.cols;
+    compute_degrees_directed(&arcs, in_degree, out_degree);
+    free(rows);
+
+    if (!params->quiet) {
+        print_run_config(params);
+        print_graph_properties(gp);
+        print_directed_graph_overview(&g, in_degree, out_degree);
+        ZF_LOGW("Directed graphs are processed on the CPU, the technique "
+                "is ignored");
+    }
+
+    tstart = get_time();
+    if (compute_par_bc_cpu(&g, bc, true, params->nthreads)) {
+        ZF_LOGF("Could not compute betweenness");
+        return EXIT_FAILURE;
+    }
+    stats.bc_comp_time = get_time() - tstart;
+    stats.nedges_traversed =
+            (unsigned long long) g.nrows * g.row_offsets[g.nrows];
+    compute_harmonic_cl_cpu(&g, cl);
+    stats.total_time = get_time() - tstart;
+
+    if (params->run_check) {
+        auto *bc_ser = (double *) malloc(g.nrows * sizeof(double));
+        if (bc_ser == 0) {
+            ZF_LOGF("Could not allocate memory");
+            return EXIT_FAILURE;
+        }
+
+        tstart = get_time();
+        compute_ser_bc_cpu(&g, bc_ser, true);
+        stats.cpu_time = get_time() - tstart;
+
+        if (!params->quiet)
+            printf("Betweenness RMSE error: %g\n",
+                   check_score(g.nrows, bc_ser, bc));
+        free(bc_ser);
+    }
+
+    if (params->dump_scores != 0)
+        dump_directed_scores(g.nrows, in_degree, out_degree, bc, cl,
+                             params->dump_scores);
+
+    if (params->dump_stats != 0) {
+        append_stats(&stats, params->dump_stats, params->technique);
+    } else if (!params->quiet) {
+        print_stats(&stats);
+    }
+
+    free(in_degree);
+    free(out_degree);
+    free(bc);
+    free(cl);
+    free_matrix_pcsr(&g);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Whether the technique computes the betweenness on the GPU, the
+ * other ones run on the CPU and need no device.
+ */
+static bool is_gpu_technique(ParStrategy technique) {
+    return technique == vertex_parallel || technique == edge_parallel ||
+           technique == work_efficient;
+}
+
 int main(int argc, char *argv[]) {
 
     params_t params;
@@ -62,7 +260,10 @@ int main(int argc, char *argv[]) {
         return EXIT_FAILURE;
     }
 
-    set_device(params.device_id);
+    bool use_gpu = is_gpu_technique(params.technique);
+
+    if (use_gpu)
+        set_device(params.device_id);
 
     if (params.verbose) {
         zf_log_set_output_level(ZF_LOG_INFO);
@@ -70,7 +271,7 @@ int main(int argc, char *argv[]) {
         zf_log_set_output_level(ZF_LOG_ERROR);
     }
 
-    if (get_compute_capability_major() < 6) {
+    if (use_gpu && get_compute_capability_major() < 6) {
         ZF_LOGF("Atomic operations for doubles are available only for compute"
                 "capability at least 6.x");
         return EXIT_FAILURE;
@@ -78,57 +279,149 @@ int main(int argc, char *argv[]) {
 
     matrix_pcsr_t m_csr;
     matrix_pcoo_t m_coo;
+    matrix_pcsr_t g;
+    matrix_pcsr_view_t g_view;
+    components_t ccs;
     gprops_t gp;
-    double tstart, tend, tstart_coo_to_csr, tend_coo_to_csr, tstart_cc,
-            tend_cc, tstart_sub_ex, tend_sub_ex;
+    double tstart, tend, tstart_coo_to_csr = 0.0, tend_coo_to_csr = 0.0,
+                         tstart_cc = 0.0, tend_cc = 0.0, tstart_sub_ex = 0.0,
+                         tend_sub_ex = 0.0;
+    bool cache_hit = false, g_mapped = false;
+    char *cname = 0;
 
     gp.has_self_loops = params.self_loops_allowed;
 
     /*
-     * Load matrix in COO format.
+     * Weighted and directed graphs skip the cache, which stores only the
+     * pattern of the largest cc of an undirected graph.
      */
-    if (query_gprops(params.input_file, &gp) ||
-        read_matrix(params.input_file, &m_coo, &gp)) {
-
+    if (query_gprops(params.input_file, &gp)) {
         ZF_LOGF("Could not read matrix %s", params.input_file);
         return EXIT_FAILURE;
     }
-    tstart_coo_to_csr = get_time();
-    coo_to_csr(&m_coo, &m_csr);
-    tend_coo_to_csr = get_time();
+
+    if (gp.is_weighted) {
+        int err = run_weighted(&params, &gp);
+        free_params(&params);
+        return err;
+    }
+
+    if (gp.is_directed) {
+        int err = run_directed(&params, &gp);
+        free_params(&params);
+        return err;
+    }
 
     /*
-     * Extract the subgraph induced by vertices of the largest cc.
+     * Harmonic and Wasserman-Faust closeness are defined on disconnected
+     * graphs, so the techniques that do not need a connected graph run on
+     * the whole graph and keep the scores of every vertex.
      */
-    matrix_pcsr_t g;
-    components_t ccs;
+    bool whole_graph = params.closeness != classic_closeness &&
+                       params.technique != approximate &&
+                       params.technique != folded &&
+                       params.technique != top_k;
 
-    tstart_cc = get_time();
-    get_cc(&m_csr, &ccs);
-    tend_cc = get_time();
+    /*
+     * Map the largest cc from the binary cache, if it is up to date.
+     */
+    if (params.use_cache && !whole_graph) {
+        cname = get_csr_cache_fname(params.input_file);
+        tstart = get_time();
+        cache_hit = (cname != 0) &&
+                    !open_csr_cache(cname, params.input_file, &g_view, &gp);
+        tend = get_time();
+        if (cache_hit) {
+            g = g_view;
+            g_mapped = true;
+            ZF_LOGI("Graph mapped from cache %s in: %g s", cname,
+                    tend - tstart);
+        }
+    }
 
-    gp.is_connected = (ccs.cc_count == 1);
-    if (!gp.is_connected) {
-        tstart_sub_ex = get_time();
-        get_largest_cc(&m_csr, &g, &ccs);
-        tend_sub_ex = get_time();
-        free_matrix_pcsr(&m_csr);
-    } else {
-        g = m_csr;
+    if (!cache_hit) {
+        /*
+         * Load matrix in COO format, the properties were queried above and
+         * are left untouched by a cache miss.
+         */
+        if (read_matrix(params.input_file, &m_coo, &gp, params.nthreads)) {
+
+            ZF_LOGF("Could not read matrix %s", params.input_file);
+            free(cname);
+            return EXIT_FAILURE;
+        }
+        tstart_coo_to_csr = get_time();
+        coo_to_csr_par(&m_coo, &m_csr, false, params.nthreads);
+        tend_coo_to_csr = get_time();
+
+        /*
+         * Extract the subgraph induced by vertices of the largest cc.
+         */
+        if (whole_graph) {
+            g = m_csr;
+        } else {
+            tstart_cc = get_time();
+            get_cc_afforest(&m_csr, &ccs, params.nthreads);
+            tend_cc = get_time();
+
+            gp.is_connected = (ccs.cc_count == 1);
+            if (!gp.is_connected) {
+                tstart_sub_ex = get_time();
+                get_largest_cc(&m_csr, &g, &ccs, params.nthreads);
+                tend_sub_ex = get_time();
+                free_matrix_pcsr(&m_csr);
+            } else {
+                g = m_csr;
+            }
+            free_ccs(&ccs);
+        }
+
+        if (cname != 0 && write_csr_cache(cname, params.input_file, &g, &gp))
+            ZF_LOGW("Could not update cache %s", cname);
     }
-    free_ccs(&ccs);
+    free(cname);
 
     tstart = get_time();
     auto degree = (int *) malloc(g.nrows * sizeof(int));
     compute_degrees_undirected(&g, degree);
     tend = get_time();
 
+    /*
+     * Relabel the vertices of the largest cc to improve the locality of the
+     * traversals. Scores are brought back to the previous ids before being
+     * dumped, as the degrees already are.
+     */
+    int *new_id = 0;
+    if (params.reorder != no_reorder) {
+        matrix_pcsr_t g_reordered;
+        double tstart_reorder = get_time();
+
+        new_id = (int *) malloc(g.nrows * sizeof(int));
+        if (new_id == 0 ||
+            get_vertex_order(&g, params.reorder, new_id) ||
+            permute_graph(&g, new_id, &g_reordered, params.nthreads)) {
+            ZF_LOGF("Could not reorder the graph");
+            return EXIT_FAILURE;
+        }
+
+        if (g_mapped)
+            close_csr_cache(&g_view);
+        else
+            free_matrix_pcsr(&g);
+        g = g_reordered;
+        g_mapped = false;
+
+        ZF_LOGI("Reordering %s executed in: %g s",
+                get_reorder_name(params.reorder), get_time() - tstart_reorder);
+    }
+
     /*
      * Print overview.
      */
     if(!params.quiet) {
         print_run_config(&params);
-        print_gpu_overview(params.device_id);
+        if (use_gpu)
+            print_gpu_overview(params.device_id);
         print_graph_properties(&gp);
         print_graph_overview(&g, degree);
 
@@ -172,14 +465,27 @@ int main(int argc, char *argv[]) {
     stats.nedges_traversed = g.nrows * g.row_offsets[g.nrows];
 
     /*
-     * Closeness centrality computation on the GPU.
+     * Closeness centrality computation on the GPU along with the GPU
+     * techniques, on the CPU for the other ones and for its variants for
+     * disconnected graphs.
      */
-    compute_cl_gpu_p(&g, cl_gpu, &stats);
+    if (params.closeness == classic_closeness && use_gpu) {
+        compute_cl_gpu_p(&g, cl_gpu, &stats);
+    } else if (compute_closeness_cpu_msbfs(&g, params.closeness, cl_gpu,
+                                           params.nthreads)) {
+        ZF_LOGF("Could not compute closeness");
+        return EXIT_FAILURE;
+    }
 
     /*
      * BC computation on the GPU.
      */
     ParStrategy technique = params.technique;
+    int *topk = 0;
+    int *topk_cl_ids = 0;
+    double *topk_cl = 0;
+    int ntopk = min(params.topk, g.nrows);
+
     switch (technique) {
         case work_efficient:
             compute_bc_gpu_wep(&g, bc_gpu, &stats);
@@ -191,6 +497,107 @@ int main(int argc, char *argv[]) {
         case edge_parallel:
             compute_bc_gpu_epp(&g, bc_gpu, &stats);
             break;
+        case approximate: {
+            double err_bound;
+            if (compute_approx_bc_cpu(&g, bc_gpu, gp.is_directed,
+                                      &params.approx, &err_bound,
+                                      params.nthreads, &stats)) {
+                ZF_LOGF("Could not approximate betweenness");
+                return EXIT_FAILURE;
+            }
+            if (!params.quiet) {
+                printf("Betweenness error bound: %g with probability %g\n",
+                       err_bound, 1.0 - params.approx.delta);
+            }
+            break;
+        }
+        case folded:
+            if (compute_folded_bc_cpu(&g, bc_gpu, params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case biconnected:
+            if (compute_bcc_bc_cpu(&g, bc_gpu, params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case twins:
+            if (compute_twin_bc_cpu(&g, bc_gpu, params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case level_sync:
+            if (compute_ls_bc_cpu(&g, bc_gpu, gp.is_directed, params.nthreads,
+                                  &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case vertex_parallel_cpu:
+            if (compute_vp_bc_cpu(&g, bc_gpu, gp.is_directed, simd_avx512,
+                                  params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case batched:
+            if (compute_batch_bc_cpu(&g, bc_gpu, gp.is_directed,
+                                     params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case algebraic:
+            if (compute_spmm_bc_cpu(&g, bc_gpu, gp.is_directed,
+                                    params.nthreads, &stats)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            break;
+        case source_parallel_cpu:
+            tstart = get_time();
+            if (compute_par_bc_cpu(&g, bc_gpu, gp.is_directed,
+                                   params.nthreads)) {
+                ZF_LOGF("Could not compute betweenness");
+                return EXIT_FAILURE;
+            }
+            stats.bc_comp_time = get_time() - tstart;
+            stats.total_time = stats.bc_comp_time;
+            break;
+        case top_k: {
+            double err_bound;
+            topk = (int *) malloc(ntopk * sizeof(int));
+            if (topk == 0 ||
+                compute_topk_bc_cpu(&g, bc_gpu, gp.is_directed, params.topk,
+                                    &params.approx, topk, &err_bound,
+                                    params.nthreads, &stats)) {
+                ZF_LOGF("Could not find the top betweenness vertices");
+                return EXIT_FAILURE;
+            }
+            if (!params.quiet) {
+                printf("Betweenness error bound: %g with probability %g\n",
+                       err_bound, 1.0 - params.approx.delta);
+            }
+
+            /*
+             * The pruning of the closeness visits relies on undirected
+             * edges.
+             */
+            if (!gp.is_directed) {
+                topk_cl_ids = (int *) malloc(ntopk * sizeof(int));
+                topk_cl = (double *) malloc(ntopk * sizeof(double));
+                if (topk_cl_ids == 0 || topk_cl == 0 ||
+                    compute_topk_cl_cpu(&g, params.topk, topk_cl_ids,
+                                        topk_cl, params.nthreads, 0)) {
+                    ZF_LOGF("Could not find the top closeness vertices");
+                    return EXIT_FAILURE;
+                }
+            }
+            break;
+        }
         default:
             ZF_LOGE("Invalid technique Id, cannot compute betweenness");
     }
@@ -206,7 +613,7 @@ int main(int argc, char *argv[]) {
         }
 
         tstart = get_time();
-        compute_ser_bc_cpu(&g, bc_cpu, gp.is_directed);
+        compute_par_bc_cpu(&g, bc_cpu, gp.is_directed, params.nthreads);
         tend = get_time();
         stats.cpu_time = tend - tstart;
 
@@ -219,7 +626,16 @@ int main(int argc, char *argv[]) {
         }
 
         tstart = get_time();
-        compute_cl_cpu(&g, cl_cpu);
+        /*
+         * The closeness and its variants are checked against a BFS from
+         * each vertex, on the graph as it is.
+         */
+        if (params.closeness == harmonic_closeness)
+            compute_harmonic_cl_cpu(&g, cl_cpu);
+        else if (params.closeness == wasserman_faust_closeness)
+            compute_wf_cl_cpu(&g, cl_cpu);
+        else
+            compute_cl_cpu_msbfs(&g, cl_cpu, params.nthreads);
         tend = get_time();
         stats.cpu_time = tend - tstart;
 
@@ -233,11 +649,44 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    /*
+     * Bring the scores and the top-k vertices back to the ids of the input
+     * graph.
+     */
+    if (new_id != 0 && (unpermute_scores(bc_gpu, new_id, g.nrows) ||
+                        unpermute_scores(cl_gpu, new_id, g.nrows) ||
+                        (topk != 0 &&
+                         unpermute_ids(topk, ntopk, new_id, g.nrows)) ||
+                        (topk_cl_ids != 0 &&
+                         unpermute_ids(topk_cl_ids, ntopk, new_id,
+                                       g.nrows)))) {
+        ZF_LOGF("Could not restore the order of the scores");
+        return EXIT_FAILURE;
+    }
+
+    /*
+     * The top-k vertices are printed when they are not dumped.
+     */
+    if (topk != 0 && params.dump_scores == 0 && !params.quiet) {
+        printf("Top %d vertices by betweenness:\n", ntopk);
+        for (int i = 0; i < ntopk; i++)
+            printf("\t%d\t%g\n", topk[i], bc_gpu[topk[i]]);
+    }
+    if (topk_cl_ids != 0 && params.dump_scores == 0 && !params.quiet) {
+        printf("Top %d vertices by closeness:\n", ntopk);
+        for (int i = 0; i < ntopk; i++)
+            printf("\t%d\t%g\n", topk_cl_ids[i], topk_cl[i]);
+    }
+
     /*
      * Dump scores and statistics if requested.
      */
     if (params.dump_scores != 0) {
-        dump_scores(g.nrows, degree, bc_gpu, cl_gpu, params.dump_scores);
+        if (topk != 0)
+            dump_selected_scores(ntopk, topk, degree, bc_gpu, cl_gpu,
+                                 params.dump_scores);
+        else
+            dump_scores(g.nrows, degree, bc_gpu, cl_gpu, params.dump_scores);
         free_params(&params);
     }
 
@@ -255,9 +704,17 @@ int main(int argc, char *argv[]) {
     free(delta);
     free(bc_gpu);
 
-    if (!gp.is_connected)
+    free(new_id);
+    free(topk);
+    free(topk_cl_ids);
+    free(topk_cl);
+
+    if (g_mapped)
+        close_csr_cache(&g_view);
+    else
         free_matrix_pcsr(&g);
 
-    cudaSafeCall(cudaDeviceReset());
+    if (use_gpu)
+        cudaSafeCall(cudaDeviceReset());
     return EXIT_SUCCESS;
 }
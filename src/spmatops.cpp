@@ -256,3 +256,172 @@ int get_R_matrix(matrix_pcsr_t *R,
 
     return EXIT_SUCCESS;
 }
+
+static inline double semiring_zero(Semiring sr) {
+    return (sr == min_plus_semiring) ? INFINITY : 0.0;
+}
+
+/**
+ * @brief Product of an entry of the pattern matrix, always one, and x.
+ */
+static inline double semiring_times_one(Semiring sr, double x) {
+    switch (sr) {
+        case min_plus_semiring:
+            return x + 1.0;
+        case lor_land_semiring:
+            return (x != 0.0) ? 1.0 : 0.0;
+        default:
+            return x;
+    }
+}
+
+static inline double semiring_plus(Semiring sr, double x, double y) {
+    switch (sr) {
+        case min_plus_semiring:
+            return (x < y) ? x : y;
+        case lor_land_semiring:
+            return (x != 0.0 || y != 0.0) ? 1.0 : 0.0;
+        default:
+            return x + y;
+    }
+}
+
+int init_matrix_block(matrix_block_t *X, int nrows, int nlanes, Semiring sr) {
+
+    size_t size = (size_t) nrows * nlanes;
+
+    X->nrows = nrows;
+    X->nlanes = nlanes;
+    X->nnzrows = 0;
+    X->rows = (int *) malloc(nrows * sizeof(int));
+    X->listed = (char *) calloc(nrows, sizeof(char));
+    X->values = (double *) malloc(size * sizeof(double));
+
+    if (X->rows == 0 || X->listed == 0 || X->values == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_matrix_block(X);
+        return EXIT_FAILURE;
+    }
+
+    double zero = semiring_zero(sr);
+    for (size_t i = 0; i < size; i++)
+        X->values[i] = zero;
+
+    return EXIT_SUCCESS;
+}
+
+void free_matrix_block(matrix_block_t *X) {
+    free(X->rows);
+    free(X->listed);
+    free(X->values);
+    X->rows = 0;
+    X->listed = 0;
+    X->values = 0;
+    X->nrows = 0;
+    X->nnzrows = 0;
+}
+
+void clear_matrix_block(matrix_block_t *X, Semiring sr) {
+
+    double zero = semiring_zero(sr);
+
+    for (int k = 0; k < X->nnzrows; k++) {
+        int i = X->rows[k];
+        double *x_i = X->values + (size_t) i * X->nlanes;
+        for (int j = 0; j < X->nlanes; j++)
+            x_i[j] = zero;
+        X->listed[i] = 0;
+    }
+    X->nnzrows = 0;
+}
+
+void list_block_row(matrix_block_t *X, int row) {
+    if (!X->listed[row]) {
+        X->listed[row] = 1;
+        X->rows[X->nnzrows++] = row;
+    }
+}
+
+int spmm_t_masked(matrix_pcsr_t *A,
+                  matrix_block_t *X,
+                  const int *mask,
+                  int mask_value,
+                  Semiring sr,
+                  matrix_block_t *C) {
+
+    if (!check_matrix_pcsr(A) || A->nrows != X->nrows ||
+        A->ncols != C->nrows || X->nlanes != C->nlanes) {
+        ZF_LOGF("Input matrices not initialized or with mismatched shapes");
+        return EXIT_FAILURE;
+    }
+
+    int nlanes = X->nlanes;
+    double zero = semiring_zero(sr);
+
+    for (int k = 0; k < X->nnzrows; k++) {
+
+        int i = X->rows[k];
+        const double *x_i = X->values + (size_t) i * nlanes;
+
+        for (int e = A->row_offsets[i]; e < A->row_offsets[i + 1]; e++) {
+
+            int w = A->cols[e];
+            double *c_w = C->values + (size_t) w * nlanes;
+            const int *m_w = (mask != 0) ? mask + (size_t) w * nlanes : 0;
+            bool updated = false;
+
+            for (int j = 0; j < nlanes; j++) {
+                if (x_i[j] != zero && (m_w == 0 || m_w[j] == mask_value)) {
+                    c_w[j] = semiring_plus(sr, c_w[j],
+                                           semiring_times_one(sr, x_i[j]));
+                    updated = true;
+                }
+            }
+
+            if (updated)
+                list_block_row(C, w);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int spmm_masked(matrix_pcsr_t *A,
+                matrix_block_t *X,
+                const int *mask,
+                int mask_value,
+                Semiring sr,
+                matrix_block_t *C) {
+
+    if (!check_matrix_pcsr(A) || A->ncols != X->nrows ||
+        A->nrows != C->nrows || X->nlanes != C->nlanes) {
+        ZF_LOGF("Input matrices not initialized or with mismatched shapes");
+        return EXIT_FAILURE;
+    }
+
+    int nlanes = X->nlanes;
+    double zero = semiring_zero(sr);
+
+    for (int k = 0; k < C->nnzrows; k++) {
+
+        int i = C->rows[k];
+        double *c_i = C->values + (size_t) i * nlanes;
+        const int *m_i = (mask != 0) ? mask + (size_t) i * nlanes : 0;
+
+        for (int j = 0; j < nlanes; j++)
+            c_i[j] = zero;
+
+        for (int e = A->row_offsets[i]; e < A->row_offsets[i + 1]; e++) {
+
+            const double *x_w = X->values + (size_t) A->cols[e] * nlanes;
+
+            for (int j = 0; j < nlanes; j++) {
+                if (m_i == 0 || m_i[j] == mask_value)
+                    c_i[j] = semiring_plus(sr, c_i[j],
+                                           semiring_times_one(sr, x_w[j]));
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
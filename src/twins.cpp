@@ -0,0 +1,256 @@
+/****************************************************************************
+ * @file twins.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * @brief Implementation of the detection of twin vertices and of the
+ * centralities computed on their representatives.
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include "twins.h"
+
+/**
+ * @brief Mixes the bits of a vertex id, so that sums of mixed ids of
+ * different sets of neighbors rarely collide.
+ */
+static inline unsigned long long mix_id(int v) {
+    unsigned long long x = (unsigned long long) v + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * @brief Groups the vertices without a class by the hash of their open or
+ * closed neighborhood and makes a class of each set of twins found in a
+ * group.
+ */
+static void find_twins(matrix_pcsr_t *g,
+                       bool closed,
+                       twins_t *t,
+                       unsigned long long *hash,
+                       int *order,
+                       int *mark) {
+
+    int nvertices = g->nrows;
+    int ncandidates = 0;
+
+    for (int v = 0; v < nvertices; v++) {
+        mark[v] = -1;
+        if (t->rep[v] != -1)
+            continue;
+
+        /*
+         * The hash does not depend on the order of the adjacency list.
+         */
+        unsigned long long h = closed ? mix_id(v) : 0;
+        for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++)
+            h += mix_id(g->cols[k]);
+
+        hash[v] = h;
+        order[ncandidates++] = v;
+    }
+
+    std::sort(order, order + ncandidates, [hash](int a, int b) {
+        return hash[a] < hash[b] || (hash[a] == hash[b] && a < b);
+    });
+
+    for (int first = 0; first < ncandidates;) {
+        int last = first + 1;
+        while (last < ncandidates && hash[order[last]] == hash[order[first]])
+            last++;
+
+        for (int i = first; i < last; i++) {
+            int r = order[i];
+            if (t->rep[r] != -1)
+                continue;
+
+            int degree = g->row_offsets[r + 1] - g->row_offsets[r];
+            t->rep[r] = r;
+            t->mult[r] = 1;
+
+            for (int k = g->row_offsets[r]; k < g->row_offsets[r + 1]; k++)
+                mark[g->cols[k]] = r;
+            if (closed)
+                mark[r] = r;
+
+            /*
+             * Hashes may collide, so candidates are checked against the
+             * neighbors of the representative.
+             */
+            for (int j = i + 1; j < last; j++) {
+                int w = order[j];
+                if (t->rep[w] != -1 ||
+                    g->row_offsets[w + 1] - g->row_offsets[w] != degree ||
+                    (closed && mark[w] != r))
+                    continue;
+
+                bool twin = true;
+                for (int k = g->row_offsets[w];
+                     k < g->row_offsets[w + 1] && twin; k++)
+                    twin = (mark[g->cols[k]] == r);
+
+                if (twin) {
+                    t->rep[w] = r;
+                    t->mult[r]++;
+                }
+            }
+        }
+
+        first = last;
+    }
+}
+
+int get_twins(matrix_pcsr_t *g, twins_t *t) {
+
+    if (!check_matrix_pcsr(g)) {
+        ZF_LOGF("The graph is not initialized");
+        return EXIT_FAILURE;
+    }
+
+    int nvertices = g->nrows;
+    auto *hash = (unsigned long long *) malloc(
+            nvertices * sizeof(unsigned long long));
+    auto *order = (int *) malloc(nvertices * sizeof(int));
+    auto *mark = (int *) malloc(nvertices * sizeof(int));
+
+    t->nvertices = nvertices;
+    t->rep = (int *) malloc(nvertices * sizeof(int));
+    t->mult = (int *) calloc(nvertices, sizeof(int));
+
+    if (hash == 0 || order == 0 || mark == 0 || t->rep == 0 ||
+        t->mult == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free(hash);
+        free(order);
+        free(mark);
+        free_twins(t);
+        return EXIT_FAILURE;
+    }
+
+    fill(t->rep, nvertices, -1);
+
+    /*
+     * A vertex cannot have both false and true twins, so the vertices left
+     * alone by the first pass are searched again for true twins.
+     */
+    find_twins(g, false, t, hash, order, mark);
+
+    for (int v = 0; v < nvertices; v++) {
+        if (t->mult[v] == 1) {
+            t->rep[v] = -1;
+            t->mult[v] = 0;
+        }
+    }
+
+    find_twins(g, true, t, hash, order, mark);
+
+    t->nclasses = 0;
+    for (int v = 0; v < nvertices; v++) {
+        if (t->mult[v] > 0)
+            t->nclasses++;
+    }
+
+    free(hash);
+    free(order);
+    free(mark);
+
+    return EXIT_SUCCESS;
+}
+
+void free_twins(twins_t *t) {
+    free(t->rep);
+    free(t->mult);
+    t->rep = 0;
+    t->mult = 0;
+}
+
+int compute_twin_bc_cpu(matrix_pcsr_t *g,
+                        double *bc_scores,
+                        int nthreads,
+                        stats_t *stats) {
+
+    double tstart = get_time();
+    twins_t t;
+
+    if (get_twins(g, &t))
+        return EXIT_FAILURE;
+
+    ZF_LOGI("Found %d classes of twins among %d vertices", t.nclasses,
+            t.nvertices);
+
+    int err = compute_multi_source_bc_cpu(g, t.mult, bc_scores, nthreads);
+
+    if (stats != 0) {
+        stats->bc_comp_time = get_time() - tstart;
+        stats->total_time = stats->bc_comp_time;
+        stats->nedges_traversed = (unsigned long long) t.nclasses *
+                                  g->row_offsets[g->nrows];
+    }
+
+    free_twins(&t);
+
+    return err;
+}
+
+int compute_twin_cl_cpu(matrix_pcsr_t *g, double *cl, int nthreads) {
+
+    twins_t t;
+
+    if (get_twins(g, &t))
+        return EXIT_FAILURE;
+
+    auto *sources = (int *) malloc(max(t.nclasses, 1) * sizeof(int));
+    if (sources == 0) {
+        ZF_LOGF("Could not allocate memory");
+        free_twins(&t);
+        return EXIT_FAILURE;
+    }
+
+    int nsources = 0;
+    for (int v = 0; v < t.nvertices; v++) {
+        if (t.mult[v] > 0)
+            sources[nsources++] = v;
+    }
+
+    int err = compute_cl_cpu_msbfs_sources(g, sources, nsources, cl,
+                                           nthreads);
+
+    if (!err) {
+        for (int v = 0; v < t.nvertices; v++)
+            cl[v] = cl[t.rep[v]];
+    }
+
+    free(sources);
+    free_twins(&t);
+
+    return err;
+}
@@ -82,7 +82,7 @@ int main(int argc, char **argv) {
     gprops_t gp;
 
     if (query_gprops(infilename, &gp) ||
-        read_matrix(infilename, &m_coo, &gp)) {
+        read_matrix(infilename, &m_coo, &gp, 0)) {
 
         fprintf(stderr, "Could not read matrix %s", infilename);
         return EXIT_FAILURE;
@@ -97,7 +97,7 @@ int main(int argc, char **argv) {
 
     gp.is_connected = (ccs.cc_count == 1);
     if (!gp.is_connected) {
-        get_largest_cc(&m_csr, &g_tmp, &ccs);
+        get_largest_cc(&m_csr, &g_tmp, &ccs, 0);
         free_matrix_pcsr(&m_csr);
     } else {
         g_tmp = m_csr;
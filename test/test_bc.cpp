@@ -0,0 +1,1063 @@
+/****************************************************************************
+ * @file test_bc.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "bc.h"
+#include "bc_approx.h"
+#include "bc_batch.h"
+#include "bc_bcc.h"
+#include "bc_fold.h"
+#include "bc_spmm.h"
+#include "bc_vp_cpu.h"
+#include "bc_weighted.h"
+#include "dynbc.h"
+#include "tests.h"
+
+static matrix_pcsr_t A;
+
+TEST_CASE("Test parallel bc on the CPU against the serial algorithm") {
+
+    /*
+     * Workspace setup for this test.
+     */
+    int source_row_offsets[] = {0, 4, 6, 9, 10, 12, 14, 15, 17, 18};
+    int source_cols[] = {1, 3, 4, 5, 0, 2, 1, 6, 7, 0, 0, 5, 0, 4, 2, 2, 8, 7};
+    int nvertices = 9;
+
+    A.nrows = nvertices;
+    A.ncols = nvertices;
+    A.cols = source_cols;
+    A.row_offsets = source_row_offsets;
+
+    double bc_ser[9], bc_par[9];
+
+    compute_ser_bc_cpu(&A, bc_ser, false);
+
+    /*
+     * Vertex 2 is crossed by all the shortest paths between {0, 1, 3, 4, 5}
+     * and {6, 7, 8} and by the ones between 6 and {7, 8}.
+     */
+    CHECK_EQ(bc_ser[2], doctest::Approx(17.0));
+
+    SUBCASE("single thread") {
+        REQUIRE_EQ(compute_par_bc_cpu(&A, bc_par, false, 1), EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_EQ(bc_par[i], bc_ser[i]);
+        }
+    }
+
+    SUBCASE("more threads than sources") {
+        REQUIRE_EQ(compute_par_bc_cpu(&A, bc_par, false, 16), EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_EQ(bc_par[i], bc_ser[i]);
+        }
+    }
+}
+
+TEST_CASE("Test approximate bc on the CPU within the error bound") {
+
+    /*
+     * Workspace setup for this test.
+     */
+    int source_row_offsets[] = {0, 4, 6, 9, 10, 12, 14, 15, 17, 18};
+    int source_cols[] = {1, 3, 4, 5, 0, 2, 1, 6, 7, 0, 0, 5, 0, 4, 2, 2, 8, 7};
+    int nvertices = 9;
+
+    A.nrows = nvertices;
+    A.ncols = nvertices;
+    A.cols = source_cols;
+    A.row_offsets = source_row_offsets;
+
+    double bc_exact[9], bc_approx[9], bc_approx2[9], err_bound;
+    compute_ser_bc_cpu(&A, bc_exact, false);
+
+    approx_params_t p;
+    p.epsilon = 0.05;
+    p.delta = 0.1;
+    p.seed = 42;
+
+    SUBCASE("uniform pivots") {
+        p.nsamples = 2000;
+        p.pivots = uniform_pivots;
+
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx, false, &p,
+                                         &err_bound, 2, 0),
+                   EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_LE(fabs(bc_approx[i] - bc_exact[i]), err_bound);
+        }
+    }
+
+    SUBCASE("degree proportional pivots") {
+        p.nsamples = 2000;
+        p.pivots = degree_pivots;
+
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx, false, &p,
+                                         &err_bound, 2, 0),
+                   EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_LE(fabs(bc_approx[i] - bc_exact[i]), err_bound);
+        }
+    }
+
+    SUBCASE("pivots independent from the number of threads") {
+        p.nsamples = 100;
+        p.pivots = degree_pivots;
+
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx, false, &p,
+                                         &err_bound, 1, 0),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx2, false, &p,
+                                         &err_bound, 3, 0),
+                   EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_EQ(bc_approx[i], bc_approx2[i]);
+        }
+    }
+
+    SUBCASE("shortest paths independent from the number of threads") {
+        p.nsamples = 0;
+
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx, false, &p,
+                                         &err_bound, 1, 0),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_approx_bc_cpu(&A, bc_approx2, false, &p,
+                                         &err_bound, 3, 0),
+                   EXIT_SUCCESS);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_LE(fabs(bc_approx[i] - bc_exact[i]), err_bound);
+            CHECK_EQ(bc_approx[i], doctest::Approx(bc_approx2[i]));
+        }
+    }
+}
+
+/**
+ * @brief Build an undirected graph from a list of edges.
+ */
+static void build_graph(matrix_pcsr_t *g, int n,
+                        const std::vector<std::pair<int, int>> &edges) {
+
+    std::vector<std::vector<int>> adj(n);
+    for (auto &e : edges) {
+        adj[e.first].push_back(e.second);
+        adj[e.second].push_back(e.first);
+    }
+
+    g->nrows = n;
+    g->ncols = n;
+    g->row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g->row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g->row_offsets[i + 1] = g->row_offsets[i] + adj[i].size();
+
+    g->cols = (int *) malloc(g->row_offsets[n] * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(), g->cols + g->row_offsets[i]);
+}
+
+/**
+ * @brief Two cycles joined by two edges, with random trees hanging from
+ * them.
+ */
+static void cycles_with_trees(int n, unsigned int seed,
+                              std::vector<std::pair<int, int>> &edges) {
+    srand(seed);
+    for (int v = 0; v < 60; v++)
+        edges.push_back(std::make_pair(v, (v + 1) % 60));
+    for (int v = 60; v < 100; v++)
+        edges.push_back(std::make_pair(v, (v == 99) ? 60 : v + 1));
+    edges.push_back(std::make_pair(0, 60));
+    edges.push_back(std::make_pair(30, 80));
+    for (int v = 100; v < n; v++)
+        edges.push_back(std::make_pair(v, rand() % v));
+}
+
+/**
+ * @brief A cycle on half of the vertices, with a random tree hanging from
+ * it on the other half.
+ */
+static void cycle_with_tree(int n, unsigned int seed,
+                            std::vector<std::pair<int, int>> &edges) {
+    srand(seed);
+    for (int v = 0; v < n / 2; v++)
+        edges.push_back(std::make_pair(v, (v + 1) % (n / 2)));
+    for (int v = n / 2; v < n; v++)
+        edges.push_back(std::make_pair(v, rand() % v));
+}
+
+/**
+ * @brief A path, whose end vertices reach the other end at depth n - 1.
+ */
+static void path(int n, std::vector<std::pair<int, int>> &edges) {
+    for (int v = 0; v + 1 < n; v++)
+        edges.push_back(std::make_pair(v, v + 1));
+}
+
+/**
+ * @brief Check the scores of an undirected graph against the serial
+ * algorithm.
+ */
+static void check_against_ser(matrix_pcsr_t *g, const double *bc_scores) {
+
+    std::vector<double> bc_ser(g->nrows);
+    compute_ser_bc_cpu(g, bc_ser.data(), false);
+
+    for (int i = 0; i < g->nrows; i++) {
+        CHECK_EQ(bc_scores[i], doctest::Approx(bc_ser[i]));
+    }
+}
+
+TEST_CASE("Test bc with degree-one folding against the parallel algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("cycles with trees attached") {
+        n = 400;
+        cycles_with_trees(n, 5, edges);
+    }
+
+    SUBCASE("tree") {
+        n = 100;
+        for (int v = 1; v < n; v++)
+            edges.push_back(std::make_pair(v, (v - 1) / 3));
+    }
+
+    SUBCASE("single edge") {
+        n = 2;
+        edges.push_back(std::make_pair(0, 1));
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_par(n), bc_fold(n);
+    REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&g, bc_par.data(), false, 2));
+
+    fold_t f;
+    REQUIRE_UNARY_FALSE(fold_degree_one(&g, &f));
+    CHECK_LT(f.ncore, n);
+    CHECK_GE(f.ncore, 1);
+    free_fold(&f);
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(compute_folded_bc_cpu(&g, bc_fold.data(),
+                                                  nthreads, 0));
+        for (int v = 0; v < n; v++)
+            CHECK_EQ(bc_fold[v], doctest::Approx(bc_par[v]).epsilon(1e-5));
+    }
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test level-synchronous bc against the serial algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("cycles with trees attached") {
+        n = 400;
+        cycles_with_trees(n, 7, edges);
+    }
+
+    SUBCASE("path whose deepest level is n - 1") {
+        n = 40;
+        path(n, edges);
+    }
+
+    SUBCASE("disconnected with isolated vertices") {
+        n = 50;
+        for (int v = 0; v < 20; v++)
+            edges.push_back(std::make_pair(v, (v + 1) % 20));
+        for (int v = 21; v < 40; v++)
+            edges.push_back(std::make_pair(v, 20 + (v - 20) / 2));
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_ls(n);
+
+    stats_t stats;
+    REQUIRE_EQ(compute_ls_bc_cpu(&g, bc_ls.data(), false, 3, &stats),
+               EXIT_SUCCESS);
+
+    check_against_ser(&g, bc_ls.data());
+    CHECK_GT(stats.nedges_traversed, 0);
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test batched bc against the serial algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("last batch partially filled") {
+        n = 8 * BATCH_LANES + 3;
+        cycle_with_tree(n, 19, edges);
+    }
+
+    SUBCASE("sources at different distances from the same vertices") {
+        /*
+         * A path, so that the vertices of a batch reach the others at
+         * distances that differ by up to BATCH_LANES - 1.
+         */
+        n = 5 * BATCH_LANES;
+        path(n, edges);
+    }
+
+    SUBCASE("disconnected") {
+        n = 3 * BATCH_LANES;
+        for (int v = 0; v < n; v += 3) {
+            edges.push_back(std::make_pair(v, v + 1));
+            edges.push_back(std::make_pair(v + 1, v + 2));
+        }
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_batch(n);
+    REQUIRE_EQ(compute_batch_bc_cpu(&g, bc_batch.data(), false, 2, 0),
+               EXIT_SUCCESS);
+
+    check_against_ser(&g, bc_batch.data());
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test algebraic bc against the serial algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("last batch partially filled") {
+        n = 6 * SPMM_BC_LANES + 5;
+        cycle_with_tree(n, 23, edges);
+    }
+
+    SUBCASE("path whose deepest level is n - 1") {
+        n = 5 * SPMM_BC_LANES;
+        path(n, edges);
+    }
+
+    SUBCASE("disconnected with isolated vertices") {
+        n = 4 * SPMM_BC_LANES;
+        for (int v = 0; v + 3 < n; v += 4) {
+            edges.push_back(std::make_pair(v, v + 1));
+            edges.push_back(std::make_pair(v + 1, v + 2));
+        }
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_spmm(n);
+
+    stats_t stats;
+    REQUIRE_EQ(compute_spmm_bc_cpu(&g, bc_spmm.data(), false, 3, &stats),
+               EXIT_SUCCESS);
+
+    check_against_ser(&g, bc_spmm.data());
+    CHECK_GT(stats.nedges_traversed, 0);
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test vectorized frontier compaction against the scalar one") {
+
+    /*
+     * A length that leaves elements after the last vector of each kernel.
+     */
+    int n = 1000 + 13;
+    std::vector<int> d(n), frontier(n), expected(n);
+
+    srand(11);
+    for (int i = 0; i < n; i++)
+        d[i] = (rand() % 4 == 0) ? INT_MAX : rand() % 6;
+
+    for (int level = simd_scalar; level <= simd_avx512; level++) {
+        for (int depth = 0; depth < 7; depth++) {
+            int len = compact_frontier(d.data(), n, depth, frontier.data(),
+                                       (SimdLevel) level);
+            int nexpected = 0;
+            for (int i = 0; i < n; i++) {
+                if (d[i] == depth)
+                    expected[nexpected++] = i;
+            }
+
+            REQUIRE_EQ(len, nexpected);
+            for (int i = 0; i < len; i++) {
+                CHECK_EQ(frontier[i], expected[i]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Test vertex-parallel bc on the CPU against the serial algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("long cycle with chords") {
+        /*
+         * The BFS has many levels.
+         */
+        n = 300;
+        srand(17);
+        for (int v = 0; v < 260; v++)
+            edges.push_back(std::make_pair(v, (v + 1) % 260));
+        for (int v = 0; v < 10; v++)
+            edges.push_back(std::make_pair(rand() % 260, rand() % 260));
+        for (int v = 260; v < 290; v++)
+            edges.push_back(std::make_pair(v, rand() % v));
+    }
+
+    SUBCASE("path whose deepest level is n - 1") {
+        n = 40;
+        path(n, edges);
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_vp(n);
+
+    for (int level = simd_scalar; level <= simd_avx512; level++) {
+        REQUIRE_EQ(compute_vp_bc_cpu(&g, bc_vp.data(), false,
+                                     (SimdLevel) level, 2, 0),
+                   EXIT_SUCCESS);
+
+        check_against_ser(&g, bc_vp.data());
+    }
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test biconnected components of a small graph") {
+
+    /*
+     * Two triangles sharing vertex 2, a bridge from 4 to 5 and a square
+     * hanging from 5.
+     */
+    std::vector<std::pair<int, int>> edges = {
+            {0, 1}, {1, 2}, {2, 0}, {2, 3}, {3, 4}, {4, 2},
+            {4, 5}, {5, 6}, {6, 7}, {7, 8}, {8, 5}};
+    int n = 10;
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    blocks_t b;
+    REQUIRE_UNARY_FALSE(get_blocks(&g, &b));
+
+    CHECK_EQ(b.nblocks, 4);
+    for (int v = 0; v < n; v++)
+        CHECK_EQ(b.is_cut[v], v == 2 || v == 4 || v == 5);
+
+    CHECK_EQ(b.cc_size[0], 9);
+    CHECK_EQ(b.cc_size[9], 1);
+
+    int nentries = 0;
+    for (int i = 0; i < b.nblocks; i++) {
+        int size = b.offsets[i + 1] - b.offsets[i];
+        CHECK_UNARY(size == 2 || size == 3 || size == 4);
+        nentries += size;
+    }
+    CHECK_EQ(nentries, 3 + 3 + 2 + 4);
+
+    free_blocks(&b);
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test bc with biconnected components against the parallel "
+          "algorithm") {
+
+    std::vector<std::pair<int, int>> edges;
+    int n;
+
+    SUBCASE("chain of cycles with chords and trees attached") {
+        /*
+         * Cycles of growing length, each one sharing a vertex with the
+         * previous one, with random chords inside them and random trees
+         * hanging from them.
+         */
+        n = 500;
+        srand(7);
+        int v = 0, len = 3;
+        while (v + len < 300) {
+            for (int i = 0; i < len; i++)
+                edges.push_back(std::make_pair(v + i, v + (i + 1) % len));
+            if (len > 4) {
+                int i = rand() % (len - 2);
+                edges.push_back(std::make_pair(v + i, v + i + 2));
+            }
+            v += len - 1;
+            len++;
+        }
+        for (int u = v + 1; u < n; u++)
+            edges.push_back(std::make_pair(u, rand() % u));
+    }
+
+    SUBCASE("biconnected graph") {
+        n = 50;
+        for (int v = 0; v < n; v++) {
+            edges.push_back(std::make_pair(v, (v + 1) % n));
+            edges.push_back(std::make_pair(v, (v + 7) % n));
+        }
+    }
+
+    SUBCASE("tree") {
+        n = 100;
+        for (int v = 1; v < n; v++)
+            edges.push_back(std::make_pair(v, (v - 1) / 3));
+    }
+
+    SUBCASE("single vertex") {
+        n = 1;
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_par(n), bc_bcc(n);
+    REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&g, bc_par.data(), false, 2));
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(compute_bcc_bc_cpu(&g, bc_bcc.data(), nthreads,
+                                               0));
+        for (int v = 0; v < n; v++)
+            CHECK_EQ(bc_bcc[v], doctest::Approx(bc_par[v]).epsilon(1e-5));
+    }
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test incremental bc against the recomputation from scratch") {
+
+    /*
+     * Two random components, joined and split again by the updates.
+     */
+    int n = 150;
+    std::vector<std::pair<int, int>> edges;
+    srand(13);
+    for (int v = 1; v < n; v++) {
+        if (v != 100)
+            edges.push_back(std::make_pair(v, (v < 100) ? rand() % v
+                                                        : 100 + rand() % (v - 100)));
+    }
+    for (int i = 0; i < 150; i++) {
+        int u = rand() % 100;
+        edges.push_back(std::make_pair(u, (u + 1 + rand() % 5) % 100));
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    dynbc_t dyn;
+    REQUIRE_UNARY_FALSE(init_dynbc(&dyn, &g, 2));
+    free_matrix_pcsr(&g);
+
+    std::vector<double> bc_par(n);
+    int naffected;
+
+    SUBCASE("random batches") {
+        for (int batch = 0; batch < 8; batch++) {
+            std::vector<edge_update_t> updates;
+            for (int i = 0; i < 1 + batch % 4; i++) {
+                edge_update_t e;
+                int u = rand() % n;
+                int deg = dyn.g.row_offsets[u + 1] - dyn.g.row_offsets[u];
+                e.u = u;
+                e.insert = (deg == 0 || rand() % 2 == 0);
+                e.v = e.insert ? rand() % n
+                               : dyn.g.cols[dyn.g.row_offsets[u] +
+                                            rand() % deg];
+                updates.push_back(e);
+            }
+
+            REQUIRE_UNARY_FALSE(update_dynbc(&dyn, updates.data(),
+                                             updates.size(), &naffected));
+            CHECK_LE(naffected, n);
+
+            REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&dyn.g, bc_par.data(),
+                                                   false, 2));
+            for (int v = 0; v < n; v++)
+                CHECK_EQ(dyn.bc_scores[v],
+                         doctest::Approx(bc_par[v]).epsilon(1e-5));
+        }
+    }
+
+    SUBCASE("joining and splitting the components") {
+        edge_update_t join = {3, 120, true};
+        REQUIRE_UNARY_FALSE(update_dynbc(&dyn, &join, 1, &naffected));
+        CHECK_EQ(naffected, n);
+
+        join.insert = false;
+        REQUIRE_UNARY_FALSE(update_dynbc(&dyn, &join, 1, &naffected));
+
+        REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&dyn.g, bc_par.data(), false,
+                                               2));
+        for (int v = 0; v < n; v++)
+            CHECK_EQ(dyn.bc_scores[v],
+                     doctest::Approx(bc_par[v]).epsilon(1e-5));
+    }
+
+    SUBCASE("updates without effect") {
+        edge_update_t noop[] = {{5, 5, true}, {7, 7, false}};
+        REQUIRE_UNARY_FALSE(update_dynbc(&dyn, noop, 2, &naffected));
+        CHECK_EQ(naffected, 0);
+
+        edge_update_t outside = {0, n, true};
+        CHECK_UNARY(update_dynbc(&dyn, &outside, 1, &naffected));
+    }
+
+    free_dynbc(&dyn);
+}
+
+TEST_CASE("Test top-k bc on the CPU against the exact algorithm") {
+
+    /*
+     * A path of hubs, each one with more leaves than the previous one, and
+     * a random graph attached to the last hub.
+     */
+    std::vector<std::pair<int, int>> edges;
+    int nhubs = 8, n = 0;
+    srand(17);
+
+    for (int h = 0; h < nhubs; h++) {
+        int hub = n++;
+        if (h > 0)
+            edges.push_back(std::make_pair(hub, hub - 1 - (h + 1) * 4));
+        for (int i = 0; i < (h + 2) * 4; i++)
+            edges.push_back(std::make_pair(hub, n++));
+    }
+    int last_hub = n - 1 - (nhubs + 1) * 4;
+    for (int v = n; v < n + 200; v++)
+        edges.push_back(std::make_pair(v, (v == n) ? last_hub : n + rand() % (v - n)));
+    n += 200;
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    std::vector<double> bc_exact(n), bc_topk(n), bc_paths(n);
+    REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&g, bc_exact.data(), false, 2));
+
+    std::vector<int> exact_order(n);
+    for (int v = 0; v < n; v++)
+        exact_order[v] = v;
+    std::sort(exact_order.begin(), exact_order.end(),
+              [&bc_exact](int a, int b) { return bc_exact[a] > bc_exact[b]; });
+
+    approx_params_t params;
+    params.nsamples = 0;
+    params.pivots = uniform_pivots;
+    params.epsilon = 0.01;
+    params.delta = 0.1;
+    params.seed = 42;
+
+    int k = 2;
+    std::vector<int> topk(k);
+    double err_bound, err_bound_paths;
+    stats_t stats, stats_paths;
+
+    REQUIRE_UNARY_FALSE(compute_topk_bc_cpu(&g, bc_topk.data(), false, k,
+                                            &params, topk.data(), &err_bound,
+                                            2, &stats));
+    REQUIRE_UNARY_FALSE(compute_approx_bc_paths(&g, bc_paths.data(), false,
+                                                &params, &err_bound_paths, 2,
+                                                &stats_paths));
+
+    std::sort(topk.begin(), topk.end());
+    std::vector<int> expected(exact_order.begin(), exact_order.begin() + k);
+    std::sort(expected.begin(), expected.end());
+
+    for (int i = 0; i < k; i++)
+        CHECK_EQ(topk[i], expected[i]);
+
+    for (int v = 0; v < n; v++)
+        CHECK_LE(fabs(bc_topk[v] - bc_exact[v]), err_bound);
+
+    /*
+     * The top vertices are separated well before the samples that bound the
+     * error of every score.
+     */
+    CHECK_LT(stats.nedges_traversed, stats_paths.nedges_traversed);
+
+    SUBCASE("more vertices than the graph") {
+        std::vector<int> all(n);
+        REQUIRE_UNARY_FALSE(compute_topk_bc_cpu(&g, bc_topk.data(), false,
+                                                n + 10, &params, all.data(),
+                                                &err_bound, 1, 0));
+        std::sort(all.begin(), all.end());
+        for (int v = 0; v < n; v++)
+            CHECK_EQ(all[v], v);
+    }
+
+    free_matrix_pcsr(&g);
+}
+
+/**
+ * @brief Copy an undirected graph adding to each edge the weight given by
+ * wgh for the pair of its endpoints.
+ */
+static void add_weights(matrix_pcsr_t *g, matrix_rcsr_t *w,
+                        int (*wgh)(int, int)) {
+
+    int n = g->nrows;
+    int nnz = g->row_offsets[n];
+
+    w->nrows = n;
+    w->ncols = n;
+    w->row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    w->cols = (int *) malloc(nnz * sizeof(int));
+    w->weights = (int *) malloc(nnz * sizeof(int));
+    std::copy(g->row_offsets, g->row_offsets + n + 1, w->row_offsets);
+    std::copy(g->cols, g->cols + nnz, w->cols);
+
+    for (int v = 0; v < n; v++) {
+        for (int k = g->row_offsets[v]; k < g->row_offsets[v + 1]; k++)
+            w->weights[k] = wgh(std::min(v, g->cols[k]),
+                                std::max(v, g->cols[k]));
+    }
+}
+
+static int unit_weight(int, int) { return 1; }
+
+static int triple_weight(int, int) { return 3; }
+
+static int mixed_weight(int u, int v) { return 1 + (u * 7 + v * 13) % 5; }
+
+TEST_CASE("Test radix heap extracts the keys in increasing order") {
+
+    radix_heap_t h;
+    radix_heap_clear(&h);
+    srand(5);
+
+    /*
+     * As in the Dijkstra algorithm, new keys are never below the last one
+     * extracted.
+     */
+    unsigned long long last = 0;
+    for (int i = 0; i < 100; i++)
+        radix_heap_push(&h, rand() % 1000, i);
+
+    for (int i = 0; i < 1000; i++) {
+        radix_item_t item = radix_heap_pop(&h);
+        CHECK_GE(item.key, last);
+        last = item.key;
+        if (i < 900)
+            radix_heap_push(&h, last + rand() % 100000, i);
+    }
+    CHECK_EQ(h.size, 0);
+}
+
+TEST_CASE("Test weighted bc and closeness on the CPU") {
+
+    SUBCASE("cycle whose heavy edge is bypassed") {
+        /*
+         * The path 2-1-0-3 of length 3 is shorter than the edge 2-3.
+         */
+        int row_offsets[] = {0, 2, 4, 6, 8};
+        int cols[] = {1, 3, 0, 2, 1, 3, 2, 0};
+        int weights[] = {1, 1, 1, 1, 1, 5, 5, 1};
+
+        matrix_rcsr_t g;
+        g.nrows = 4;
+        g.ncols = 4;
+        g.row_offsets = row_offsets;
+        g.cols = cols;
+        g.weights = weights;
+
+        double bc[4], cl[4];
+        REQUIRE_EQ(compute_dijkstra_bc_cpu(&g, bc, false, 2, 0),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_dijkstra_cl_cpu(&g, cl, 2), EXIT_SUCCESS);
+
+        CHECK_EQ(bc[0], 2.0);
+        CHECK_EQ(bc[1], 2.0);
+        CHECK_EQ(bc[2], 0.0);
+        CHECK_EQ(bc[3], 0.0);
+        CHECK_EQ(cl[0], 0.75);
+        CHECK_EQ(cl[2], 0.5);
+
+        /*
+         * Zero weights would break the count of the shortest paths.
+         */
+        weights[0] = 0;
+        CHECK_EQ(compute_dijkstra_bc_cpu(&g, bc, false, 1, 0), EXIT_FAILURE);
+    }
+
+    SUBCASE("directed path shorter than the direct edge") {
+        int row_offsets[] = {0, 2, 3, 3};
+        int cols[] = {1, 2, 2};
+        int weights[] = {1, 5, 2};
+
+        matrix_rcsr_t g;
+        g.nrows = 3;
+        g.ncols = 3;
+        g.row_offsets = row_offsets;
+        g.cols = cols;
+        g.weights = weights;
+
+        double bc[3];
+        REQUIRE_EQ(compute_dijkstra_bc_cpu(&g, bc, true, 1, 0),
+                   EXIT_SUCCESS);
+
+        CHECK_EQ(bc[0], 0.0);
+        CHECK_EQ(bc[1], 1.0);
+        CHECK_EQ(bc[2], 0.0);
+    }
+
+    SUBCASE("random graph against the unweighted and the all pairs "
+            "algorithms") {
+        int n = 60;
+        std::vector<std::pair<int, int>> edges;
+        srand(11);
+        for (int v = 1; v < n; v++) {
+            edges.push_back(std::make_pair(v, rand() % v));
+            edges.push_back(std::make_pair(v, rand() % v));
+        }
+
+        matrix_pcsr_t g;
+        build_graph(&g, n, edges);
+
+        std::vector<double> bc_par(n), bc(n), bc3(n), cl(n), cl3(n);
+        matrix_rcsr_t g_unit, g_triple, g_mixed;
+        add_weights(&g, &g_unit, unit_weight);
+        add_weights(&g, &g_triple, triple_weight);
+        add_weights(&g, &g_mixed, mixed_weight);
+
+        /*
+         * Uniform weights only scale the distances.
+         */
+        compute_par_bc_cpu(&g, bc_par.data(), false, 1);
+        REQUIRE_EQ(compute_dijkstra_bc_cpu(&g_unit, bc.data(), false, 2, 0),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_dijkstra_bc_cpu(&g_triple, bc3.data(), false, 2,
+                                           0), EXIT_SUCCESS);
+        REQUIRE_EQ(compute_dijkstra_cl_cpu(&g_unit, cl.data(), 2),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_dijkstra_cl_cpu(&g_triple, cl3.data(), 2),
+                   EXIT_SUCCESS);
+
+        for (int v = 0; v < n; v++) {
+            CHECK_EQ(bc[v], doctest::Approx(bc_par[v]));
+            CHECK_EQ(bc3[v], doctest::Approx(bc[v]));
+            CHECK_EQ(cl3[v] * 3, doctest::Approx(cl[v]));
+        }
+
+        /*
+         * Floyd-Warshall distances and path counts.
+         */
+        const unsigned long long inf = ULLONG_MAX / 4;
+        std::vector<std::vector<unsigned long long>> d(
+                n, std::vector<unsigned long long>(n, inf));
+        std::vector<std::vector<double>> sigma(n, std::vector<double>(n, 0));
+
+        for (int v = 0; v < n; v++) {
+            d[v][v] = 0;
+            sigma[v][v] = 1;
+            for (int k = g_mixed.row_offsets[v];
+                 k < g_mixed.row_offsets[v + 1]; k++) {
+                int w = g_mixed.cols[k];
+                auto weight = (unsigned long long) g_mixed.weights[k];
+                if (weight < d[v][w]) {
+                    d[v][w] = weight;
+                    sigma[v][w] = 1;
+                } else if (weight == d[v][w]) {
+                    sigma[v][w] += 1;
+                }
+            }
+        }
+
+        for (int u = 0; u < n; u++)
+            for (int s = 0; s < n; s++)
+                for (int t = 0; t < n; t++)
+                    if (d[s][u] + d[u][t] < d[s][t])
+                        d[s][t] = d[s][u] + d[u][t];
+
+        /*
+         * Paths are counted by their last edge, in increasing length.
+         */
+        for (int s = 0; s < n; s++) {
+            std::vector<int> by_dist(n);
+            for (int t = 0; t < n; t++)
+                by_dist[t] = t;
+            std::sort(by_dist.begin(), by_dist.end(),
+                      [&](int a, int b) { return d[s][a] < d[s][b]; });
+            for (int t : by_dist) {
+                if (t == s)
+                    continue;
+                sigma[s][t] = 0;
+                for (int k = g_mixed.row_offsets[t];
+                     k < g_mixed.row_offsets[t + 1]; k++) {
+                    int v = g_mixed.cols[k];
+                    if (d[s][v] + g_mixed.weights[k] == d[s][t])
+                        sigma[s][t] += sigma[s][v];
+                }
+            }
+        }
+
+        REQUIRE_EQ(compute_dijkstra_bc_cpu(&g_mixed, bc.data(), false, 2, 0),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(compute_dijkstra_cl_cpu(&g_mixed, cl.data(), 2),
+                   EXIT_SUCCESS);
+
+        for (int v = 0; v < n; v++) {
+            double expected = 0.0;
+            unsigned long long farness = 0;
+            for (int s = 0; s < n; s++) {
+                farness += d[v][s];
+                for (int t = 0; t < n; t++) {
+                    if (s != v && t != v && s != t &&
+                        d[s][v] + d[v][t] == d[s][t])
+                        expected += sigma[s][v] * sigma[v][t] / sigma[s][t];
+                }
+            }
+            CHECK_EQ(bc[v], doctest::Approx(expected / 2));
+            CHECK_EQ(cl[v], doctest::Approx((n - 1.0) / farness));
+        }
+
+        free_matrix_pcsr(&g);
+        free_matrix_rcsr(&g_unit);
+        free_matrix_rcsr(&g_triple);
+        free_matrix_rcsr(&g_mixed);
+    }
+}
+
+TEST_CASE("Test bc of directed graphs against all pairs shortest paths") {
+
+    /*
+     * Random arcs, so that many pairs are connected in one direction only.
+     */
+    int n = 40;
+    srand(13);
+    std::vector<std::vector<int>> adj(n);
+    for (int k = 0; k < 3 * n; k++) {
+        int u = rand() % n, v = rand() % n;
+        if (u != v && std::find(adj[u].begin(), adj[u].end(), v) ==
+                      adj[u].end())
+            adj[u].push_back(v);
+    }
+
+    matrix_pcsr_t g;
+    g.nrows = n;
+    g.ncols = n;
+    g.row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g.row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g.row_offsets[i + 1] = g.row_offsets[i] + adj[i].size();
+    g.cols = (int *) malloc(g.row_offsets[n] * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(), g.cols + g.row_offsets[i]);
+
+    /*
+     * Distances and number of shortest paths of every pair by BFS.
+     */
+    std::vector<std::vector<int>> d(n, std::vector<int>(n, INT_MAX));
+    std::vector<std::vector<double>> sigma(n, std::vector<double>(n, 0));
+    for (int s = 0; s < n; s++) {
+        std::vector<int> q(1, s);
+        d[s][s] = 0;
+        sigma[s][s] = 1;
+        for (size_t h = 0; h < q.size(); h++) {
+            int v = q[h];
+            for (int w : adj[v]) {
+                if (d[s][w] == INT_MAX) {
+                    d[s][w] = d[s][v] + 1;
+                    q.push_back(w);
+                }
+                if (d[s][w] == d[s][v] + 1)
+                    sigma[s][w] += sigma[s][v];
+            }
+        }
+    }
+
+    std::vector<double> bc_ser(n), bc_par(n), bc_ls(n), bc_batch(n),
+            bc_spmm(n);
+    compute_ser_bc_cpu(&g, bc_ser.data(), true);
+    REQUIRE_EQ(compute_par_bc_cpu(&g, bc_par.data(), true, 3), EXIT_SUCCESS);
+    REQUIRE_EQ(compute_ls_bc_cpu(&g, bc_ls.data(), true, 3, 0), EXIT_SUCCESS);
+    REQUIRE_EQ(compute_batch_bc_cpu(&g, bc_batch.data(), true, 3, 0),
+               EXIT_SUCCESS);
+    REQUIRE_EQ(compute_spmm_bc_cpu(&g, bc_spmm.data(), true, 3, 0),
+               EXIT_SUCCESS);
+
+    for (int v = 0; v < n; v++) {
+        double expected = 0.0;
+        for (int s = 0; s < n; s++) {
+            for (int t = 0; t < n; t++) {
+                if (s != v && t != v && s != t && d[s][v] != INT_MAX &&
+                    d[v][t] != INT_MAX && d[s][v] + d[v][t] == d[s][t])
+                    expected += sigma[s][v] * sigma[v][t] / sigma[s][t];
+            }
+        }
+        CHECK_EQ(bc_ser[v], doctest::Approx(expected));
+        CHECK_EQ(bc_par[v], bc_ser[v]);
+        CHECK_EQ(bc_ls[v], doctest::Approx(bc_ser[v]));
+        CHECK_EQ(bc_batch[v], doctest::Approx(bc_ser[v]));
+        CHECK_EQ(bc_spmm[v], doctest::Approx(bc_ser[v]));
+    }
+
+    /*
+     * With many pivots the approximate scores follow the arcs forward as
+     * the exact ones.
+     */
+    approx_params_t p;
+    p.epsilon = 0.05;
+    p.delta = 0.1;
+    p.seed = 42;
+    p.nsamples = 20000;
+    p.pivots = uniform_pivots;
+
+    std::vector<double> bc_approx(n);
+    double err_bound;
+    REQUIRE_EQ(compute_approx_bc_cpu(&g, bc_approx.data(), true, &p,
+                                     &err_bound, 3, 0),
+               EXIT_SUCCESS);
+
+    for (int v = 0; v < n; v++) {
+        CHECK_LE(fabs(bc_approx[v] - bc_ser[v]), err_bound);
+        CHECK_LE(fabs(bc_approx[v] - bc_ser[v]), 0.1 * (bc_ser[v] + n));
+    }
+
+    free_matrix_pcsr(&g);
+}
@@ -265,7 +265,7 @@ TEST_CASE("Test largest connected component extraction of undirected unweighted
          * R = [ 0 1 4 5 6 ]
          * C = [ 1 0 2 3 1 1 ]
          */
-        get_largest_cc(&A, &subgraph, &ccs);
+        get_largest_cc(&A, &subgraph, &ccs, 0);
 
         print_matrix_pcsr(&subgraph);
 
@@ -331,7 +331,7 @@ TEST_CASE("Test largest connected component extraction of undirected unweighted
          * R = [ 0 1 3 6 7 8 ]
          * C = [ 1 0 2 1 4 3 2 2 ]
          */
-        get_largest_cc(&A, &subgraph, &ccs);
+        get_largest_cc(&A, &subgraph, &ccs, 0);
 
         int nrows = subgraph.nrows;
         int expected_row_offsets[] = {0, 1, 3, 6, 7, 8};
@@ -351,3 +351,264 @@ TEST_CASE("Test largest connected component extraction of undirected unweighted
         free_matrix_pcsr(&subgraph);
     }
 }
+
+TEST_CASE("Test connected components with direction-optimizing BFS") {
+
+    /*
+     * Workspace setup for this test.
+     */
+    int source_row_offsets[] = {0, 1, 4, 5, 7, 8, 10, 12};
+    int source_cols[] = {1, 0, 2, 4, 1, 5, 6, 1, 3, 6, 3, 5};
+
+    A.nrows = 7;
+    A.ncols = 7;
+    A.cols = source_cols;
+    A.row_offsets = source_row_offsets;
+
+    components_t ccs;
+    REQUIRE_EQ(get_cc_bfs(&A, &ccs), EXIT_SUCCESS);
+
+    /*
+     * Ensure the graph has two connected components.
+     */
+    REQUIRE_EQ(ccs.cc_count, 2);
+    REQUIRE_EQ(ccs.cc_size[0], 4);
+    REQUIRE_EQ(ccs.cc_size[1], 3);
+
+    /*
+     * Vertices of the first cc are 0 1 2 4 in BFS order, the ones of the
+     * second cc are 3 5 6.
+     */
+    int cc[] = {0, 1, 2, 4, 3, 5, 6};
+    for (int i = 0; i < A.nrows; i++) {
+        CHECK_EQ(ccs.array[i], cc[i]);
+    }
+
+    free_ccs(&ccs);
+}
+
+TEST_CASE("Test direction-optimizing BFS against the top-down BFS") {
+
+    /*
+     * Workspace setup for this test. Vertex 0 is a hub, so the second level
+     * is expanded bottom-up.
+     */
+    int source_row_offsets[] = {0, 4, 6, 9, 10, 12, 14, 15, 17, 18};
+    int source_cols[] = {1, 3, 4, 5, 0, 2, 1, 6, 7, 0, 0, 5, 0, 4, 2, 2, 8, 7};
+    int nvertices = 9;
+
+    A.nrows = nvertices;
+    A.ncols = nvertices;
+    A.cols = source_cols;
+    A.row_offsets = source_row_offsets;
+
+    int d[9], d_dir_opt[9];
+    bfs_workspace_t ws;
+    REQUIRE_EQ(init_bfs_workspace(&ws, nvertices), EXIT_SUCCESS);
+
+    for (int s = 0; s < nvertices; s++) {
+        fill(d, nvertices, INT_MAX);
+        fill(d_dir_opt, nvertices, INT_MAX);
+
+        BFS_visit(&A, d, s);
+        int ecc = BFS_visit_dir_opt(&A, d_dir_opt, s, &ws);
+
+        CHECK_EQ(ws.nvisited, nvertices);
+        CHECK_EQ(ecc, d[argmax(d, nvertices)]);
+
+        for (int i = 0; i < nvertices; i++) {
+            CHECK_EQ(d_dir_opt[i], d[i]);
+        }
+    }
+
+    free_bfs_workspace(&ws);
+}
+
+TEST_CASE("Test subgraph extraction by relabeling against SpRef") {
+
+    /*
+     * Random graph with duplicated entries, so that rows of the subgraph
+     * must be deduplicated as done by SpRef.
+     */
+    const int nvertices = 3000, nentries = 30000;
+    auto *rows = (int *) malloc(nentries * sizeof(int));
+    auto *cols = (int *) malloc(nentries * sizeof(int));
+    REQUIRE_UNARY(rows);
+    REQUIRE_UNARY(cols);
+
+    srand(3);
+    for (int n = 0; n < nentries; n += 2) {
+        bool duplicate = (n % 10 == 2);
+        rows[n] = duplicate ? rows[n - 2] : rand() % nvertices;
+        cols[n] = duplicate ? cols[n - 2] : rand() % 300;
+        rows[n + 1] = cols[n];
+        cols[n + 1] = rows[n];
+    }
+
+    matrix_pcoo_t coo = {nvertices, nvertices, nentries, rows, cols};
+    REQUIRE_UNARY_FALSE(coo_to_csr(&coo, &A));
+
+    std::vector<int> vertices;
+    for (int v = 0; v < nvertices; v += 1 + v % 3)
+        vertices.push_back(v);
+
+    matrix_pcsr_t C, C_ref;
+    extract_subgraph(vertices.data(), (int) vertices.size(), &A, &C_ref);
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(extract_subgraph_relabel(vertices.data(),
+                                                     (int) vertices.size(),
+                                                     &A, &C, nthreads));
+        REQUIRE_EQ(C.nrows, C_ref.nrows);
+        REQUIRE_EQ(C.ncols, C_ref.ncols);
+
+        for (int i = 0; i <= C.nrows; i++)
+            REQUIRE_EQ(C.row_offsets[i], C_ref.row_offsets[i]);
+        for (int k = 0; k < C.row_offsets[C.nrows]; k++)
+            REQUIRE_EQ(C.cols[k], C_ref.cols[k]);
+
+        free_matrix_pcsr(&C);
+    }
+
+    std::vector<int> new_id(nvertices, -1);
+    REQUIRE_UNARY_FALSE(extract_subgraph_map(vertices.data(),
+                                             (int) vertices.size(), &A, &C,
+                                             new_id.data()));
+    for (int i = 0; i <= C.nrows; i++)
+        REQUIRE_EQ(C.row_offsets[i], C_ref.row_offsets[i]);
+    for (int k = 0; k < C.row_offsets[C.nrows]; k++)
+        REQUIRE_EQ(C.cols[k], C_ref.cols[k]);
+    for (int v = 0; v < nvertices; v++)
+        REQUIRE_EQ(new_id[v], -1);
+    free_matrix_pcsr(&C);
+
+    free_matrix_pcsr(&C_ref);
+    free_matrix_pcsr(&A);
+    free(rows);
+    free(cols);
+}
+
+TEST_CASE("Test connected components with Afforest against BFS visits") {
+
+    /*
+     * A large cc made of a long path with random chords, plus many small
+     * components made of pairs and isolated vertices.
+     */
+    const int nvertices = 20000, nlarge = 12000;
+    std::vector<int> rows, cols;
+
+    srand(11);
+    for (int v = 1; v < nlarge; v++) {
+        rows.push_back(v - 1);
+        cols.push_back(v);
+        if (v % 5 == 0) {
+            rows.push_back(v);
+            cols.push_back(rand() % nlarge);
+        }
+    }
+    for (int v = nlarge; v + 1 < nvertices; v += 3) {
+        rows.push_back(v + 1);
+        cols.push_back(v);
+    }
+
+    int nedges = (int) rows.size();
+    for (int n = 0; n < nedges; n++) {
+        rows.push_back(cols[n]);
+        cols.push_back(rows[n]);
+    }
+
+    matrix_pcoo_t coo = {nvertices, nvertices, (int) rows.size(),
+                         rows.data(), cols.data()};
+    REQUIRE_UNARY_FALSE(coo_to_csr(&coo, &A));
+
+    components_t ccs_bfs, ccs;
+    REQUIRE_UNARY_FALSE(get_cc_bfs(&A, &ccs_bfs));
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(get_cc_afforest(&A, &ccs, nthreads));
+        REQUIRE_EQ(ccs.cc_count, ccs_bfs.cc_count);
+
+        for (int i = 0, start = 0; i < ccs.cc_count; i++) {
+            REQUIRE_EQ(ccs.cc_size[i], ccs_bfs.cc_size[i]);
+
+            std::vector<int> expected(ccs_bfs.array + start,
+                                      ccs_bfs.array + start +
+                                      ccs_bfs.cc_size[i]);
+            std::sort(expected.begin(), expected.end());
+
+            for (int j = 0; j < ccs.cc_size[i]; j++)
+                REQUIRE_EQ(ccs.array[start + j], expected[j]);
+
+            start += ccs.cc_size[i];
+        }
+        free_ccs(&ccs);
+    }
+
+    free_ccs(&ccs_bfs);
+    free_matrix_pcsr(&A);
+
+    /*
+     * No vertex to sample the most frequent component from.
+     */
+    int empty_row_offsets[] = {0};
+    matrix_pcsr_t E = {0, 0, empty_row_offsets, 0};
+    REQUIRE_UNARY_FALSE(get_cc_afforest(&E, &ccs, 2));
+    CHECK_EQ(ccs.cc_count, 0);
+    free_ccs(&ccs);
+}
+
+TEST_CASE("Test strongly and weakly connected components of a directed "
+          "graph") {
+
+    /*
+     * Cycles {0, 1, 2} and {3, 4} joined by the arc 2 -> 3, the sink 5 is
+     * reached only by the last arc of 2 and 6 is isolated. Skipping the
+     * arcs of the largest component after the first rounds would lose 5.
+     */
+    matrix_pcsr_t A;
+    int row_offsets[] = {0, 1, 2, 5, 6, 7, 7, 7};
+    int cols[] = {1, 2, 0, 3, 5, 4, 3};
+
+    A.nrows = 7;
+    A.ncols = 7;
+    A.row_offsets = row_offsets;
+    A.cols = cols;
+
+    components_t ccs;
+    REQUIRE_UNARY_FALSE(get_scc(&A, &ccs));
+    REQUIRE_EQ(ccs.cc_count, 4);
+
+    std::vector<int> comp(7);
+    for (int i = 0, start = 0; i < ccs.cc_count; i++) {
+        for (int j = start; j < start + ccs.cc_size[i]; j++)
+            comp[ccs.array[j]] = i;
+        start += ccs.cc_size[i];
+    }
+
+    CHECK_EQ(comp[0], comp[1]);
+    CHECK_EQ(comp[1], comp[2]);
+    CHECK_EQ(comp[3], comp[4]);
+    CHECK_NE(comp[2], comp[3]);
+    CHECK_NE(comp[5], comp[4]);
+    CHECK_NE(comp[6], comp[0]);
+
+    /*
+     * A component comes after the ones it reaches.
+     */
+    CHECK_GT(comp[2], comp[3]);
+    CHECK_GT(comp[2], comp[5]);
+    free_ccs(&ccs);
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(get_wcc(&A, &ccs, nthreads));
+        REQUIRE_EQ(ccs.cc_count, 2);
+        CHECK_EQ(ccs.cc_size[0], 6);
+        CHECK_EQ(ccs.cc_size[1], 1);
+
+        for (int j = 0; j < 6; j++)
+            CHECK_EQ(ccs.array[j], j);
+        CHECK_EQ(ccs.array[6], 6);
+
+        free_ccs(&ccs);
+    }
+}
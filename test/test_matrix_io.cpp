@@ -268,3 +268,235 @@ TEST_CASE("Test graph loading using mmio with some corner cases") {
         close_stream(tmp);
     }
 }
+
+TEST_CASE("Test binary CSR cache round trip and invalidation") {
+
+    const char *gname = "cache_test.mtx";
+    FILE *tmp = fopen(gname, "w");
+    REQUIRE_UNARY(tmp);
+
+    char tmp_mm_header[] = "%%MatrixMarket matrix coordinate pattern symmetric";
+    int tmp_header[] = {4, 4, 3};
+    int tmp_row[] = {2, 3, 4};
+    int tmp_col[] = {1, 2, 3};
+
+    write_tmp_file(tmp, tmp_mm_header, tmp_header, tmp_row, tmp_col, nullptr);
+    close_stream(tmp);
+
+    int row_offsets[] = {0, 1, 3, 5, 6};
+    int cols[] = {1, 0, 2, 1, 3, 2};
+    matrix_pcsr_t g_in = {4, 4, row_offsets, cols};
+    matrix_pcsr_t g_out;
+
+    gprops_t gp_in;
+    gp_in.is_directed = false;
+    gp_in.is_weighted = false;
+    gp_in.has_self_loops = false;
+    gp_in.is_connected = true;
+
+    char *cname = get_csr_cache_fname(gname);
+    REQUIRE_UNARY(cname);
+    remove(cname);
+
+    SUBCASE("round trip") {
+        gprops_t gp_out;
+        gp_out.has_self_loops = false;
+
+        CHECK_UNARY(read_csr_cache(cname, gname, &g_out, &gp_out));
+        REQUIRE_UNARY_FALSE(write_csr_cache(cname, gname, &g_in, &gp_in));
+        REQUIRE_UNARY_FALSE(read_csr_cache(cname, gname, &g_out, &gp_out));
+
+        CHECK_EQ(g_out.nrows, g_in.nrows);
+        CHECK_EQ(g_out.ncols, g_in.ncols);
+        for (int i = 0; i < g_in.nrows + 1; i++)
+            CHECK_EQ(g_out.row_offsets[i], g_in.row_offsets[i]);
+        for (int i = 0; i < g_in.row_offsets[g_in.nrows]; i++)
+            CHECK_EQ(g_out.cols[i], g_in.cols[i]);
+        CHECK_EQ(gp_out.is_directed, gp_in.is_directed);
+        CHECK_EQ(gp_out.is_connected, gp_in.is_connected);
+
+        free_matrix_pcsr(&g_out);
+    }
+
+    SUBCASE("zero-copy mapping") {
+        gprops_t gp_out;
+        gp_out.has_self_loops = false;
+        matrix_pcsr_view_t g_view;
+
+        REQUIRE_UNARY_FALSE(write_csr_cache(cname, gname, &g_in, &gp_in));
+        REQUIRE_UNARY_FALSE(open_csr_cache(cname, gname, &g_view, &gp_out));
+
+        CHECK_EQ(g_view.nrows, g_in.nrows);
+        CHECK_EQ(g_view.row_offsets[g_view.nrows], 6);
+        for (int i = 0; i < g_in.row_offsets[g_in.nrows]; i++)
+            CHECK_EQ(g_view.cols[i], g_in.cols[i]);
+        CHECK_EQ((char *) g_view.row_offsets,
+                 (char *) g_view.mapping + sizeof(csr_cache_header_t));
+
+        close_csr_cache(&g_view);
+        CHECK_EQ(g_view.mapping, nullptr);
+        CHECK_UNARY_FALSE(check_matrix_pcsr(&g_view));
+    }
+
+    SUBCASE("different self loops policy") {
+        gprops_t gp_out;
+        gp_out.has_self_loops = true;
+
+        REQUIRE_UNARY_FALSE(write_csr_cache(cname, gname, &g_in, &gp_in));
+        CHECK_UNARY(read_csr_cache(cname, gname, &g_out, &gp_out));
+    }
+
+    SUBCASE("modified input file") {
+        gprops_t gp_out;
+        gp_out.has_self_loops = false;
+
+        REQUIRE_UNARY_FALSE(write_csr_cache(cname, gname, &g_in, &gp_in));
+
+        tmp = fopen(gname, "a");
+        REQUIRE_UNARY(tmp);
+        fprintf(tmp, "%d %d\n", 4, 1);
+        close_stream(tmp);
+
+        CHECK_UNARY(read_csr_cache(cname, gname, &g_out, &gp_out));
+    }
+
+    remove(cname);
+    remove(gname);
+    free(cname);
+}
+
+TEST_CASE("Test parallel parsing of pattern matrices") {
+
+    const char *gname = "par_test.mtx";
+    const int nvertices = 1000, nedges = 6000;
+    gprops_t gp_ser, gp_par;
+    matrix_pcoo_t coo_ser, coo_par;
+
+    gp_ser.is_directed = false;
+    gp_ser.has_self_loops = false;
+    gp_par = gp_ser;
+
+    SUBCASE("same entries of the serial reader") {
+        FILE *tmp = fopen(gname, "w");
+        REQUIRE_UNARY(tmp);
+
+        srand(42);
+        fprintf(tmp, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+        fprintf(tmp, "%% generated by the test\n");
+        fprintf(tmp, "%d %d %d\n", nvertices, nvertices, nedges);
+        for (int i = 0; i < nedges; i++) {
+            int u = (int) gen_random_in_range(1, nvertices);
+            int v = (i % 100 == 0) ? u : (int) gen_random_in_range(1, nvertices);
+            fprintf(tmp, (i % 2) ? "%d %d\n" : "%d\t%d \n", u, v);
+        }
+        close_stream(tmp);
+
+        tmp = fopen(gname, "r");
+        REQUIRE_UNARY(tmp);
+        REQUIRE_UNARY_FALSE(read_mm_pattern(tmp, &coo_ser, &gp_ser));
+        close_stream(tmp);
+
+        for (int nthreads = 1; nthreads <= 8; nthreads *= 2) {
+            REQUIRE_UNARY_FALSE(read_mm_pattern_par(gname, &coo_par, &gp_par,
+                                                    nthreads));
+            CHECK_EQ(gp_par.is_directed, false);
+            CHECK_EQ(coo_par.nrows, nvertices);
+            REQUIRE_EQ(coo_par.nnz, coo_ser.nnz);
+
+            for (int i = 0; i < coo_par.nnz; i++) {
+                CHECK_EQ(coo_par.rows[i], coo_ser.rows[i]);
+                CHECK_EQ(coo_par.cols[i], coo_ser.cols[i]);
+            }
+            free_matrix_pcoo(&coo_par);
+        }
+        free_matrix_pcoo(&coo_ser);
+    }
+
+    SUBCASE("comments and carriage returns in the body") {
+        FILE *tmp = fopen(gname, "w");
+        REQUIRE_UNARY(tmp);
+
+        fprintf(tmp, "%%%%MatrixMarket matrix coordinate pattern general\n");
+        fprintf(tmp, "3 3 3\n1 2\r\n%% comment\n\n2 3\n3 1");
+        close_stream(tmp);
+
+        REQUIRE_UNARY_FALSE(read_mm_pattern_par(gname, &coo_par, &gp_par, 2));
+        CHECK_EQ(gp_par.is_directed, true);
+        REQUIRE_EQ(coo_par.nnz, 3);
+        CHECK_EQ(coo_par.rows[2], 2);
+        CHECK_EQ(coo_par.cols[2], 0);
+        free_matrix_pcoo(&coo_par);
+    }
+
+    SUBCASE("malformed and missing entries") {
+        FILE *tmp = fopen(gname, "w");
+        REQUIRE_UNARY(tmp);
+        fprintf(tmp, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+        fprintf(tmp, "3 3 2\n1 2\n2 x\n");
+        close_stream(tmp);
+
+        CHECK_UNARY(read_mm_pattern_par(gname, &coo_par, &gp_par, 2));
+
+        tmp = fopen(gname, "w");
+        REQUIRE_UNARY(tmp);
+        fprintf(tmp, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+        fprintf(tmp, "3 3 3\n1 2\n2 3\n");
+        close_stream(tmp);
+
+        CHECK_UNARY(read_mm_pattern_par(gname, &coo_par, &gp_par, 2));
+
+        tmp = fopen(gname, "w");
+        REQUIRE_UNARY(tmp);
+        fprintf(tmp, "%%%%MatrixMarket matrix coordinate pattern symmetric\n");
+        fprintf(tmp, "3 3 2\n1 2\n2 -3\n");
+        close_stream(tmp);
+
+        CHECK_UNARY(read_mm_pattern_par(gname, &coo_par, &gp_par, 2));
+    }
+
+    remove(gname);
+}
+
+TEST_CASE("Test loading of weighted graphs") {
+
+    const char *gname = "wgh_test.mtx";
+    gprops_t gp;
+    matrix_rcoo_t coo;
+    matrix_rcsr_t csr_w;
+
+    FILE *tmp = fopen(gname, "w");
+    REQUIRE_UNARY(tmp);
+    fprintf(tmp, "%%%%MatrixMarket matrix coordinate real symmetric\n");
+    fprintf(tmp, "4 4 4\n2 1 3\n3 2 4\n3 3 7\n4 1 2\n");
+    close_stream(tmp);
+
+    REQUIRE_EQ(query_gprops(gname, &gp), EXIT_SUCCESS);
+    CHECK_EQ(gp.is_weighted, true);
+
+    /*
+     * The self-loop is dropped and the other entries are mirrored.
+     */
+    gp.has_self_loops = false;
+    REQUIRE_EQ(read_matrix_real(gname, &coo, &gp), EXIT_SUCCESS);
+    CHECK_EQ(coo.nrows, 4);
+    CHECK_EQ(coo.ncols, 4);
+    CHECK_EQ(coo.nnz, 6);
+
+    REQUIRE_EQ(rcoo_to_rcsr(&coo, &csr_w), EXIT_SUCCESS);
+
+    int row_offsets[] = {0, 2, 4, 5, 6};
+    int cols[] = {1, 3, 0, 2, 1, 0};
+    int weights[] = {3, 2, 3, 4, 4, 2};
+
+    for (int i = 0; i < 5; i++)
+        CHECK_EQ(csr_w.row_offsets[i], row_offsets[i]);
+
+    for (int i = 0; i < 6; i++) {
+        CHECK_EQ(csr_w.cols[i], cols[i]);
+        CHECK_EQ(csr_w.weights[i], weights[i]);
+    }
+
+    free_matrix_rcoo(&coo);
+    free_matrix_rcsr(&csr_w);
+    remove(gname);
+}
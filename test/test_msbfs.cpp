@@ -0,0 +1,382 @@
+/****************************************************************************
+ * @file test_msbfs.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "cl.h"
+#include "ecc.h"
+#include "msbfs.h"
+#include "tests.h"
+
+/**
+ * @brief Build an undirected ring of n vertices with a chord from each
+ * vertex multiple of ten to the opposite one.
+ */
+static void build_ring(matrix_pcsr_t *g, int n) {
+
+    std::vector<std::vector<int>> adj(n);
+
+    for (int i = 0; i < n; i++) {
+        adj[i].push_back((i + 1) % n);
+        adj[(i + 1) % n].push_back(i);
+        if (i % 10 == 0 && i < n / 2) {
+            adj[i].push_back(i + n / 2);
+            adj[i + n / 2].push_back(i);
+        }
+    }
+
+    g->nrows = n;
+    g->ncols = n;
+    g->row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g->row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g->row_offsets[i + 1] = g->row_offsets[i] + adj[i].size();
+
+    g->cols = (int *) malloc(g->row_offsets[n] * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(),
+                  g->cols + g->row_offsets[i]);
+}
+
+TEST_CASE("Test multi-source BFS against one BFS per source") {
+
+    /*
+     * More vertices than the sources of a batch, with the last batch
+     * partially filled.
+     */
+    matrix_pcsr_t g;
+    int n = MSBFS_LANES + 45;
+    build_ring(&g, n);
+
+    auto cl = (double *) malloc(n * sizeof(double));
+    auto cl_msbfs = (double *) malloc(n * sizeof(double));
+    auto ecc = (int *) malloc(n * sizeof(int));
+    auto ecc_msbfs = (int *) malloc(n * sizeof(int));
+
+    compute_cl_cpu(&g, cl);
+    get_vertices_eccentricity(&g, ecc);
+
+    REQUIRE_EQ(compute_cl_cpu_msbfs(&g, cl_msbfs, 2), EXIT_SUCCESS);
+    REQUIRE_EQ(get_vertices_eccentricity_msbfs(&g, ecc_msbfs, 2),
+               EXIT_SUCCESS);
+
+    for (int i = 0; i < n; i++) {
+        CHECK_EQ(cl_msbfs[i], cl[i]);
+        CHECK_EQ(ecc_msbfs[i], ecc[i]);
+    }
+
+    CHECK_EQ(get_diameter(&g), ecc[argmax(ecc, n)]);
+    CHECK_EQ(get_radius(&g), *std::min_element(ecc, ecc + n));
+
+    free(cl);
+    free(cl_msbfs);
+    free(ecc);
+    free(ecc_msbfs);
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test multi-source BFS with disconnected undirected graph") {
+
+    /*
+     * Workspace setup for this test.
+     */
+    matrix_pcsr_t g;
+    int source_row_offsets[] = {0, 1, 4, 5, 7, 8, 10, 12};
+    int source_cols[] = {1, 0, 2, 4, 1, 5, 6, 1, 3, 6, 3, 5};
+
+    g.nrows = 7;
+    g.ncols = 7;
+    g.cols = source_cols;
+    g.row_offsets = source_row_offsets;
+
+    msbfs_workspace_t ws;
+    REQUIRE_EQ(init_msbfs_workspace(&ws, g.nrows), EXIT_SUCCESS);
+
+    int sources[] = {0, 1, 2, 3, 4, 5, 6};
+    msbfs_visit(&g, sources, g.nrows, &ws);
+
+    /*
+     * Vertex 0 reaches 1 at distance 1 and 2, 4 at distance 2.
+     */
+    CHECK_EQ(ws.nreached[0], 4);
+    CHECK_EQ(ws.dist_sum[0], 5);
+    CHECK_EQ(ws.ecc[0], 2);
+
+    /*
+     * Vertex 3 reaches 5 and 6 at distance 1.
+     */
+    CHECK_EQ(ws.nreached[3], 3);
+    CHECK_EQ(ws.dist_sum[3], 2);
+    CHECK_EQ(ws.ecc[3], 1);
+
+    free_msbfs_workspace(&ws);
+
+    int ecc[7];
+    REQUIRE_EQ(get_vertices_eccentricity_msbfs(&g, ecc, 1), EXIT_SUCCESS);
+
+    for (int i = 0; i < g.nrows; i++) {
+        CHECK_EQ(ecc[i], INT_MAX);
+    }
+
+    CHECK_EQ(get_diameter(&g), INT_MAX);
+    CHECK_EQ(get_radius(&g), INT_MAX);
+}
+
+TEST_CASE("Test top-k closeness against the closeness of every vertex") {
+
+    matrix_pcsr_t g;
+    int n = 600;
+    build_ring(&g, n);
+
+    auto cl = (double *) malloc(n * sizeof(double));
+    auto order = (int *) malloc(n * sizeof(int));
+
+    compute_cl_cpu(&g, cl);
+
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+
+    std::stable_sort(order, order + n,
+                     [cl](int a, int b) { return cl[a] > cl[b]; });
+
+    int ks[] = {1, 10, 50, n + 1};
+
+    for (int k : ks) {
+
+        int ntopk = std::min(k, n);
+        auto topk = (int *) malloc(ntopk * sizeof(int));
+        auto topk_cl = (double *) malloc(ntopk * sizeof(double));
+        unsigned long long nedges = 0;
+
+        REQUIRE_EQ(compute_topk_cl_cpu(&g, k, topk, topk_cl, 2, &nedges),
+                   EXIT_SUCCESS);
+
+        for (int i = 0; i < ntopk; i++) {
+            CHECK_EQ(topk[i], order[i]);
+            CHECK_EQ(topk_cl[i], cl[order[i]]);
+        }
+
+        /*
+         * Visits from the vertices far from the chords are cut early.
+         */
+        if (k < n)
+            CHECK_LT(nedges, (unsigned long long) n * g.row_offsets[n]);
+
+        free(topk);
+        free(topk_cl);
+    }
+
+    free(cl);
+    free(order);
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test diameter and radius against the eccentricity of every vertex") {
+
+    /*
+     * Random trees with a few more edges, whose eccentricities are spread
+     * over many values.
+     */
+    srand(3);
+
+    for (int t = 0; t < 20; t++) {
+
+        int n = 50 + rand() % 200;
+        int nextra = rand() % 8;
+        std::vector<std::vector<int>> adj(n);
+
+        for (int v = 1; v < n + nextra; v++) {
+            int u = (v < n) ? v : rand() % n;
+            int w = rand() % u;
+            adj[u].push_back(w);
+            adj[w].push_back(u);
+        }
+
+        matrix_pcsr_t g;
+        g.nrows = n;
+        g.ncols = n;
+        g.row_offsets = (int *) malloc((n + 1) * sizeof(int));
+        g.row_offsets[0] = 0;
+        for (int i = 0; i < n; i++)
+            g.row_offsets[i + 1] = g.row_offsets[i] + adj[i].size();
+
+        g.cols = (int *) malloc(g.row_offsets[n] * sizeof(int));
+        for (int i = 0; i < n; i++)
+            std::copy(adj[i].begin(), adj[i].end(),
+                      g.cols + g.row_offsets[i]);
+
+        auto ecc = (int *) malloc(n * sizeof(int));
+        get_vertices_eccentricity(&g, ecc);
+
+        CHECK_EQ(get_diameter(&g), ecc[argmax(ecc, n)]);
+        CHECK_EQ(get_radius(&g), *std::min_element(ecc, ecc + n));
+
+        free(ecc);
+        free_matrix_pcsr(&g);
+    }
+}
+
+TEST_CASE("Test diameter whose endpoints are not all in the last fringe") {
+
+    /*
+     * The longest path 5 - 1 - 0 - 3 - 8 has length 4, while the fringes
+     * visited by iFUB first have a smaller eccentricity.
+     */
+    int edges[][2] = {{1, 0}, {2, 0}, {3, 2}, {4, 3}, {5, 1}, {6, 4},
+                      {7, 6}, {8, 3}, {4, 1}, {3, 0}, {7, 0}};
+    int n = 9;
+    std::vector<std::vector<int>> adj(n);
+
+    for (auto &e : edges) {
+        adj[e[0]].push_back(e[1]);
+        adj[e[1]].push_back(e[0]);
+    }
+
+    /*
+     * Sorted rows, as read from a matrix file.
+     */
+    for (auto &row : adj)
+        std::sort(row.begin(), row.end());
+
+    matrix_pcsr_t g;
+    g.nrows = n;
+    g.ncols = n;
+    g.row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g.row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g.row_offsets[i + 1] = g.row_offsets[i] + adj[i].size();
+
+    g.cols = (int *) malloc(g.row_offsets[n] * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(), g.cols + g.row_offsets[i]);
+
+    int ecc[9];
+    get_vertices_eccentricity(&g, ecc);
+
+    CHECK_EQ(ecc[argmax(ecc, n)], 4);
+    CHECK_EQ(get_diameter(&g), 4);
+
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test harmonic closeness of a directed graph") {
+
+    /*
+     * Path 0 -> 1 -> 2 -> 3 with the arc 3 -> 1 back.
+     */
+    matrix_pcsr_t g;
+    int row_offsets[] = {0, 1, 2, 3, 4};
+    int cols[] = {1, 2, 3, 1};
+
+    g.nrows = 4;
+    g.ncols = 4;
+    g.row_offsets = row_offsets;
+    g.cols = cols;
+
+    double cl[4];
+    compute_harmonic_cl_cpu(&g, cl);
+
+    CHECK_EQ(cl[0], doctest::Approx((1.0 + 1.0 / 2 + 1.0 / 3) / 3));
+    CHECK_EQ(cl[1], doctest::Approx((1.0 + 1.0 / 2) / 3));
+    CHECK_EQ(cl[2], doctest::Approx((1.0 + 1.0 / 2) / 3));
+    CHECK_EQ(cl[3], doctest::Approx((1.0 + 1.0 / 2) / 3));
+}
+
+TEST_CASE("Test closeness variants with disconnected undirected graph") {
+
+    /*
+     * Components {0, 1, 2, 4} and {3, 5, 6}, as in the test of the
+     * multi-source BFS.
+     */
+    matrix_pcsr_t g;
+    int source_row_offsets[] = {0, 1, 4, 5, 7, 8, 10, 12};
+    int source_cols[] = {1, 0, 2, 4, 1, 5, 6, 1, 3, 6, 3, 5};
+
+    g.nrows = 7;
+    g.ncols = 7;
+    g.cols = source_cols;
+    g.row_offsets = source_row_offsets;
+
+    double cl[7], cl_msbfs[7];
+
+    compute_harmonic_cl_cpu(&g, cl);
+    REQUIRE_EQ(compute_closeness_cpu_msbfs(&g, harmonic_closeness, cl_msbfs,
+                                           2),
+               EXIT_SUCCESS);
+
+    for (int i = 0; i < g.nrows; i++) {
+        CHECK_EQ(cl_msbfs[i], doctest::Approx(cl[i]));
+    }
+    CHECK_EQ(cl[0], doctest::Approx((1.0 + 1.0 / 2 + 1.0 / 2) / 6));
+
+    compute_wf_cl_cpu(&g, cl);
+    REQUIRE_EQ(compute_closeness_cpu_msbfs(&g, wasserman_faust_closeness,
+                                           cl_msbfs, 2),
+               EXIT_SUCCESS);
+
+    for (int i = 0; i < g.nrows; i++) {
+        CHECK_EQ(cl_msbfs[i], doctest::Approx(cl[i]));
+    }
+
+    /*
+     * Vertex 0 reaches 3 vertices at total distance 5, vertex 3 reaches 2
+     * at total distance 2.
+     */
+    CHECK_EQ(cl[0], doctest::Approx(3.0 * 3.0 / (6.0 * 5.0)));
+    CHECK_EQ(cl[3], doctest::Approx(2.0 * 2.0 / (6.0 * 2.0)));
+}
+
+TEST_CASE("Test Wasserman-Faust closeness of a connected graph") {
+
+    /*
+     * Every vertex reaches the whole graph, so the scaling has no effect.
+     */
+    matrix_pcsr_t g;
+    int n = MSBFS_LANES + 45;
+    build_ring(&g, n);
+
+    auto cl = (double *) malloc(n * sizeof(double));
+    auto cl_wf = (double *) malloc(n * sizeof(double));
+
+    compute_cl_cpu(&g, cl);
+    REQUIRE_EQ(compute_closeness_cpu_msbfs(&g, wasserman_faust_closeness,
+                                           cl_wf, 2),
+               EXIT_SUCCESS);
+
+    for (int i = 0; i < n; i++) {
+        CHECK_EQ(cl_wf[i], doctest::Approx(cl[i]));
+    }
+
+    free(cl);
+    free(cl_wf);
+    free_matrix_pcsr(&g);
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+ * @file test_reorder.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#include "bc.h"
+#include "reorder.h"
+#include "tests.h"
+
+/**
+ * @brief Build an undirected path of n vertices whose ids are scrambled, plus
+ * a chord every seven vertices.
+ */
+static void build_scrambled_path(matrix_pcsr_t *g, int n) {
+
+    std::vector<std::vector<int>> adj(n);
+    auto id = [n](int i) { return (int) ((37LL * i + 11) % n); };
+
+    for (int i = 0; i + 1 < n; i++) {
+        adj[id(i)].push_back(id(i + 1));
+        adj[id(i + 1)].push_back(id(i));
+        if (i % 7 == 0 && i + 3 < n) {
+            adj[id(i)].push_back(id(i + 3));
+            adj[id(i + 3)].push_back(id(i));
+        }
+    }
+
+    g->nrows = n;
+    g->ncols = n;
+    g->row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g->row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g->row_offsets[i + 1] = g->row_offsets[i] + adj[i].size();
+
+    g->cols = (int *) malloc(g->row_offsets[n] * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(),
+                  g->cols + g->row_offsets[i]);
+}
+
+static int get_bandwidth(matrix_pcsr_t *g) {
+
+    int bandwidth = 0;
+    for (int i = 0; i < g->nrows; i++) {
+        for (int j = g->row_offsets[i]; j < g->row_offsets[i + 1]; j++)
+            bandwidth = max(bandwidth, abs(g->cols[j] - i));
+    }
+    return bandwidth;
+}
+
+static double get_average_gap(matrix_pcsr_t *g) {
+
+    double gap = 0.0;
+    for (int i = 0; i < g->nrows; i++) {
+        for (int j = g->row_offsets[i]; j < g->row_offsets[i + 1]; j++)
+            gap += abs(g->cols[j] - i);
+    }
+    return gap / g->row_offsets[g->nrows];
+}
+
+TEST_CASE("Test vertex reordering strategies") {
+
+    const int n = 500;
+    matrix_pcsr_t g, h;
+    build_scrambled_path(&g, n);
+
+    int new_id[n];
+    double bc[n], bc_reordered[n];
+    REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&g, bc, false, 2));
+
+    for (int s = no_reorder; s <= locality_reorder; s++) {
+        auto strategy = (ReorderStrategy) s;
+        CAPTURE(get_reorder_name(strategy));
+
+        REQUIRE_UNARY_FALSE(get_vertex_order(&g, strategy, new_id));
+
+        /*
+         * The new ids must be a permutation.
+         */
+        std::vector<bool> used(n, false);
+        for (int v = 0; v < n; v++) {
+            REQUIRE_GE(new_id[v], 0);
+            REQUIRE_LT(new_id[v], n);
+            REQUIRE_UNARY_FALSE(used[new_id[v]]);
+            used[new_id[v]] = true;
+        }
+
+        REQUIRE_UNARY_FALSE(permute_graph(&g, new_id, &h, 2));
+        REQUIRE_EQ(h.row_offsets[n], g.row_offsets[n]);
+
+        for (int v = 0; v < n; v++) {
+            int i = new_id[v];
+            REQUIRE_EQ(h.row_offsets[i + 1] - h.row_offsets[i],
+                       g.row_offsets[v + 1] - g.row_offsets[v]);
+            for (int j = g.row_offsets[v]; j < g.row_offsets[v + 1]; j++) {
+                CHECK_UNARY(std::binary_search(h.cols + h.row_offsets[i],
+                                               h.cols + h.row_offsets[i + 1],
+                                               new_id[g.cols[j]]));
+            }
+        }
+
+        /*
+         * Scores computed on the relabeled graph are the same once restored
+         * to the original ids.
+         */
+        REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&h, bc_reordered, false, 2));
+        REQUIRE_UNARY_FALSE(unpermute_scores(bc_reordered, new_id, n));
+        for (int v = 0; v < n; v++)
+            CHECK_EQ(bc_reordered[v], doctest::Approx(bc[v]));
+
+        if (strategy == rcm_reorder)
+            CHECK_LT(get_bandwidth(&h), get_bandwidth(&g) / 10);
+
+        if (strategy == locality_reorder)
+            CHECK_LT(get_average_gap(&h), get_average_gap(&g) / 10);
+
+        if (strategy == degree_reorder) {
+            for (int i = 0; i + 1 < n; i++)
+                CHECK_GE(h.row_offsets[i + 1] - h.row_offsets[i],
+                         h.row_offsets[i + 2] - h.row_offsets[i + 1]);
+        }
+
+        free_matrix_pcsr(&h);
+    }
+
+    free_matrix_pcsr(&g);
+}
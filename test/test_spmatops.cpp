@@ -111,6 +111,87 @@ TEST_CASE("Test sparse matrix in CSR format transposition") {
     }
 }
 
+TEST_CASE("Test parallel conversion from COO to CSR and transposition") {
+
+    /*
+     * Enough random entries, with duplicates, to be split among threads.
+     */
+    const int nrows = 2000, nnz = 400000;
+    auto *rows = (int *) malloc(nnz * sizeof(int));
+    auto *cols = (int *) malloc(nnz * sizeof(int));
+    REQUIRE_UNARY(rows);
+    REQUIRE_UNARY(cols);
+
+    srand(7);
+    for (int n = 0; n < nnz; n++) {
+        rows[n] = rand() % nrows;
+        cols[n] = rand() % (nrows / 2);
+    }
+
+    coo.nnz = nnz;
+    coo.nrows = nrows;
+    coo.ncols = nrows / 2;
+    coo.rows = rows;
+    coo.cols = cols;
+
+    coo_to_csr(&coo, &csr);
+    transpose(&csr, &Q);
+
+    for (int nthreads = 1; nthreads <= 8; nthreads *= 2) {
+        matrix_pcsr_t csr_par, q_par;
+
+        REQUIRE_UNARY_FALSE(coo_to_csr_par(&coo, &csr_par, false, nthreads));
+        REQUIRE_UNARY_FALSE(transpose_par(&csr_par, &q_par, nthreads));
+
+        REQUIRE_EQ(csr_par.nrows, csr.nrows);
+        REQUIRE_EQ(q_par.nrows, Q.nrows);
+        for (int i = 0; i <= nrows; i++)
+            REQUIRE_EQ(csr_par.row_offsets[i], csr.row_offsets[i]);
+        for (int n = 0; n < nnz; n++)
+            REQUIRE_EQ(csr_par.cols[n], csr.cols[n]);
+        for (int i = 0; i <= Q.nrows; i++)
+            REQUIRE_EQ(q_par.row_offsets[i], Q.row_offsets[i]);
+        for (int n = 0; n < nnz; n++)
+            REQUIRE_EQ(q_par.cols[n], Q.cols[n]);
+
+        free_matrix_pcsr(&csr_par);
+        free_matrix_pcsr(&q_par);
+    }
+
+    SUBCASE("sorted rows without duplicates") {
+        matrix_pcsr_t csr_par;
+
+        REQUIRE_UNARY_FALSE(coo_to_csr_par(&coo, &csr_par, true, 4));
+        REQUIRE_EQ(csr_par.nrows, nrows);
+
+        for (int i = 0; i < nrows; i++) {
+            /*
+             * Same set of columns of the unsorted row.
+             */
+            std::vector<int> expected(csr.cols + csr.row_offsets[i],
+                                      csr.cols + csr.row_offsets[i + 1]);
+            std::sort(expected.begin(), expected.end());
+            expected.erase(std::unique(expected.begin(), expected.end()),
+                           expected.end());
+
+            REQUIRE_EQ(csr_par.row_offsets[i + 1] - csr_par.row_offsets[i],
+                       (int) expected.size());
+            for (int j = csr_par.row_offsets[i];
+                 j < csr_par.row_offsets[i + 1]; j++)
+                CHECK_EQ(csr_par.cols[j],
+                         expected[j - csr_par.row_offsets[i]]);
+        }
+        CHECK_LT(csr_par.row_offsets[nrows], nnz);
+
+        free_matrix_pcsr(&csr_par);
+    }
+
+    free_matrix_pcsr(&csr);
+    free_matrix_pcsr(&Q);
+    free(rows);
+    free(cols);
+}
+
 TEST_CASE("Test spgemm on two pattern matrices") {
 
     /*******************
@@ -220,3 +301,132 @@ TEST_CASE("Test spref on three pattern matrices") {
         CHECK_EQ(C.cols[i], expected_cols[i]);
     }
 }
+
+TEST_CASE("Test masked spmm over the semirings") {
+
+    /*
+     * Directed graph 0 -> 1, 0 -> 2, 1 -> 3, 2 -> 3 (4 x 4)
+     */
+    int a_row_offsets[] = {0, 2, 3, 4, 4};
+    int a_cols[] = {1, 2, 3, 3};
+
+    A.nrows = 4;
+    A.ncols = 4;
+    A.cols = a_cols;
+    A.row_offsets = a_row_offsets;
+
+    matrix_block_t X, Y;
+
+    SUBCASE("paths counted pushing along the rows") {
+        REQUIRE_EQ(init_matrix_block(&X, 4, 2, plus_times_semiring),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(init_matrix_block(&Y, 4, 2, plus_times_semiring),
+                   EXIT_SUCCESS);
+
+        X.values[0 * 2 + 0] = 1.0;
+        X.values[1 * 2 + 1] = 1.0;
+        list_block_row(&X, 0);
+        list_block_row(&X, 1);
+
+        REQUIRE_EQ(spmm_t_masked(&A, &X, 0, 0, plus_times_semiring, &Y),
+                   EXIT_SUCCESS);
+
+        double expected[] = {0, 0, 1, 0, 1, 0, 0, 1};
+        for (int i = 0; i < 8; i++) {
+            CHECK_EQ(Y.values[i], expected[i]);
+        }
+        CHECK_EQ(Y.nnzrows, 3);
+
+        /*
+         * Vertex 3 is reached twice in lane 0, while lane 1 is masked.
+         */
+        int mask[] = {0, 0, 0, 0, 0, 0, 1, 0};
+        clear_matrix_block(&X, plus_times_semiring);
+        REQUIRE_EQ(spmm_t_masked(&A, &Y, mask, 1, plus_times_semiring, &X),
+                   EXIT_SUCCESS);
+
+        CHECK_EQ(X.nnzrows, 1);
+        CHECK_EQ(X.values[3 * 2 + 0], 2.0);
+        CHECK_EQ(X.values[3 * 2 + 1], 0.0);
+    }
+
+    SUBCASE("distances relaxed pushing along the rows") {
+        REQUIRE_EQ(init_matrix_block(&X, 4, 2, min_plus_semiring),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(init_matrix_block(&Y, 4, 2, min_plus_semiring),
+                   EXIT_SUCCESS);
+
+        X.values[0 * 2 + 0] = 0.0;
+        X.values[2 * 2 + 1] = 0.0;
+        list_block_row(&X, 0);
+        list_block_row(&X, 2);
+
+        REQUIRE_EQ(spmm_t_masked(&A, &X, 0, 0, min_plus_semiring, &Y),
+                   EXIT_SUCCESS);
+
+        CHECK_EQ(Y.values[1 * 2 + 0], 1.0);
+        CHECK_EQ(Y.values[2 * 2 + 0], 1.0);
+        CHECK_EQ(Y.values[3 * 2 + 1], 1.0);
+        CHECK(std::isinf(Y.values[0 * 2 + 0]));
+        CHECK(std::isinf(Y.values[3 * 2 + 0]));
+
+        clear_matrix_block(&Y, min_plus_semiring);
+        for (int i = 0; i < 8; i++) {
+            CHECK(std::isinf(Y.values[i]));
+        }
+        CHECK_EQ(Y.nnzrows, 0);
+    }
+
+    SUBCASE("dependencies pulled from the columns of the rows") {
+        REQUIRE_EQ(init_matrix_block(&X, 4, 2, plus_times_semiring),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(init_matrix_block(&Y, 4, 2, plus_times_semiring),
+                   EXIT_SUCCESS);
+
+        X.values[3 * 2 + 0] = 5.0;
+        X.values[3 * 2 + 1] = 7.0;
+        list_block_row(&X, 3);
+
+        /*
+         * Entry (2, 1) is masked and stays zero.
+         */
+        int mask[] = {0, 0, 1, 1, 1, 0, 0, 0};
+        list_block_row(&Y, 1);
+        list_block_row(&Y, 2);
+        Y.values[2 * 2 + 1] = 3.0;
+
+        REQUIRE_EQ(spmm_masked(&A, &X, mask, 1, plus_times_semiring, &Y),
+                   EXIT_SUCCESS);
+
+        CHECK_EQ(Y.values[1 * 2 + 0], 5.0);
+        CHECK_EQ(Y.values[1 * 2 + 1], 7.0);
+        CHECK_EQ(Y.values[2 * 2 + 0], 5.0);
+        CHECK_EQ(Y.values[2 * 2 + 1], 0.0);
+        CHECK_EQ(Y.values[0 * 2 + 0], 0.0);
+    }
+
+    SUBCASE("reachability pulled from the columns of the rows") {
+        REQUIRE_EQ(init_matrix_block(&X, 4, 2, lor_land_semiring),
+                   EXIT_SUCCESS);
+        REQUIRE_EQ(init_matrix_block(&Y, 4, 2, lor_land_semiring),
+                   EXIT_SUCCESS);
+
+        X.values[1 * 2 + 1] = 1.0;
+        X.values[3 * 2 + 1] = 1.0;
+        list_block_row(&X, 1);
+        list_block_row(&X, 3);
+        list_block_row(&Y, 0);
+        list_block_row(&Y, 2);
+
+        REQUIRE_EQ(spmm_masked(&A, &X, 0, 0, lor_land_semiring, &Y),
+                   EXIT_SUCCESS);
+
+        CHECK_EQ(Y.values[0 * 2 + 0], 0.0);
+        CHECK_EQ(Y.values[0 * 2 + 1], 1.0);
+        CHECK_EQ(Y.values[2 * 2 + 0], 0.0);
+        CHECK_EQ(Y.values[2 * 2 + 1], 1.0);
+    }
+
+    free_matrix_block(&X);
+    free_matrix_block(&Y);
+}
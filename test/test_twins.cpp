@@ -0,0 +1,165 @@
+/****************************************************************************
+ * @file test_twins.cpp
+ * @author Riccardo Battistini <riccardo.battistini2(at)studio.unibo.it>
+ *
+ * Copyright 2021 (c) 2021 by Riccardo Battistini
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its
+ * contributors may be used to endorse or promote products derived from this
+ * software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ * ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+#include "bc.h"
+#include "cl.h"
+#include "twins.h"
+#include "tests.h"
+#include <set>
+
+/**
+ * @brief Build an undirected graph without multiple edges from a set of
+ * edges.
+ */
+static void build_graph(matrix_pcsr_t *g, int n,
+                        const std::set<std::pair<int, int>> &edges) {
+
+    std::vector<std::vector<int>> adj(n);
+    for (auto &e : edges) {
+        adj[e.first].push_back(e.second);
+        adj[e.second].push_back(e.first);
+    }
+
+    g->nrows = n;
+    g->ncols = n;
+    g->row_offsets = (int *) malloc((n + 1) * sizeof(int));
+    g->row_offsets[0] = 0;
+    for (int i = 0; i < n; i++)
+        g->row_offsets[i + 1] = g->row_offsets[i] + adj[i].size();
+
+    g->cols = (int *) malloc(max(g->row_offsets[n], 1) * sizeof(int));
+    for (int i = 0; i < n; i++)
+        std::copy(adj[i].begin(), adj[i].end(), g->cols + g->row_offsets[i]);
+}
+
+static void add_edge(std::set<std::pair<int, int>> &edges, int u, int v) {
+    if (u != v)
+        edges.insert(std::make_pair(min(u, v), max(u, v)));
+}
+
+TEST_CASE("Test detection of twins") {
+
+    /*
+     * 0 and 1 are false twins adjacent to 2 and 3, 4 and 5 are true twins
+     * adjacent to 3, 6 is adjacent to 3 only and 7 is isolated.
+     */
+    std::set<std::pair<int, int>> edges;
+    add_edge(edges, 0, 2);
+    add_edge(edges, 0, 3);
+    add_edge(edges, 1, 2);
+    add_edge(edges, 1, 3);
+    add_edge(edges, 4, 5);
+    add_edge(edges, 4, 3);
+    add_edge(edges, 5, 3);
+    add_edge(edges, 6, 3);
+
+    matrix_pcsr_t g;
+    build_graph(&g, 8, edges);
+
+    twins_t t;
+    REQUIRE_UNARY_FALSE(get_twins(&g, &t));
+
+    int expected_rep[] = {0, 0, 2, 3, 4, 4, 6, 7};
+    for (int v = 0; v < 8; v++)
+        CHECK_EQ(t.rep[v], expected_rep[v]);
+
+    CHECK_EQ(t.nclasses, 6);
+    CHECK_EQ(t.mult[0], 2);
+    CHECK_EQ(t.mult[1], 0);
+    CHECK_EQ(t.mult[4], 2);
+    CHECK_EQ(t.mult[6], 1);
+
+    free_twins(&t);
+    free_matrix_pcsr(&g);
+}
+
+TEST_CASE("Test centralities with twins against the uncompressed ones") {
+
+    /*
+     * Co-authorship graph of random papers, each one a clique of its
+     * authors. The authors of a single paper are true twins, the readers
+     * of the same pair of papers are false twins.
+     */
+    int nauthors = 300, npapers = 200, nreaders = 60;
+    int n = nauthors + nreaders;
+    std::set<std::pair<int, int>> edges;
+    srand(11);
+
+    for (int p = 0; p < npapers; p++) {
+        int nwriters = 2 + rand() % 4;
+        int writers[5];
+        for (int i = 0; i < nwriters; i++) {
+            writers[i] = (rand() % 3 == 0) ? rand() % nauthors
+                                           : (p * 3 + i) % nauthors;
+            for (int j = 0; j < i; j++)
+                add_edge(edges, writers[i], writers[j]);
+        }
+    }
+
+    for (int r = 0; r < nreaders; r++) {
+        add_edge(edges, nauthors + r, (r % 10) * 7);
+        add_edge(edges, nauthors + r, (r % 10) * 7 + 100);
+    }
+
+    matrix_pcsr_t g;
+    build_graph(&g, n, edges);
+
+    twins_t t;
+    REQUIRE_UNARY_FALSE(get_twins(&g, &t));
+    CHECK_LT(t.nclasses, n);
+
+    for (int v = 0; v < n; v++) {
+        int r = t.rep[v];
+        CHECK_LE(r, v);
+        CHECK_EQ(g.row_offsets[v + 1] - g.row_offsets[v],
+                 g.row_offsets[r + 1] - g.row_offsets[r]);
+    }
+    free_twins(&t);
+
+    std::vector<double> bc_par(n), bc_twin(n), cl(n), cl_twin(n);
+    REQUIRE_UNARY_FALSE(compute_par_bc_cpu(&g, bc_par.data(), false, 2));
+    compute_cl_cpu(&g, cl.data());
+
+    for (int nthreads = 1; nthreads <= 4; nthreads *= 2) {
+        REQUIRE_UNARY_FALSE(compute_twin_bc_cpu(&g, bc_twin.data(), nthreads,
+                                                0));
+        REQUIRE_UNARY_FALSE(compute_twin_cl_cpu(&g, cl_twin.data(),
+                                                nthreads));
+        for (int v = 0; v < n; v++) {
+            CHECK_EQ(bc_twin[v], doctest::Approx(bc_par[v]).epsilon(1e-5));
+            CHECK_EQ(cl_twin[v], cl[v]);
+        }
+    }
+
+    free_matrix_pcsr(&g);
+}